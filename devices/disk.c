@@ -7,6 +7,7 @@
 #include "threads/io.h"
 #include "threads/interrupt.h"
 #include "threads/synch.h"
+#include "threads/thread.h"
 
 /* The code in this file is an interface to an ATA (IDE)
    controller.  It attempts to comply to [ATA-3]. */
@@ -119,7 +120,7 @@ disk_init (void) {
 			default:
 				NOT_REACHED ();
 		}
-		lock_init (&c->lock);
+		lock_init_named (&c->lock, c->name);
 		c->expecting_interrupt = false;
 		sema_init (&c->completion_wait, 0);
 
@@ -223,6 +224,7 @@ disk_read (struct disk *d, disk_sector_t sec_no, void *buffer) {
 		PANIC ("%s: disk read failed, sector=%"PRDSNu, d->name, sec_no);
 	input_sector (c, buffer);
 	d->read_cnt++;
+	thread_current ()->rusage.sectors_read++;
 	lock_release (&c->lock);
 }
 
@@ -247,6 +249,7 @@ disk_write (struct disk *d, disk_sector_t sec_no, const void *buffer) {
 	output_sector (c, buffer);
 	sema_down (&c->completion_wait);
 	d->write_cnt++;
+	thread_current ()->rusage.sectors_written++;
 	lock_release (&c->lock);
 }
 
@@ -7,6 +7,7 @@
 
 #include "threads/interrupt.h"
 #include "threads/io.h"
+#include "threads/profile.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
 
@@ -24,6 +25,39 @@
 /* Number of timer ticks since OS booted. */
 static int64_t ticks;
 
+/* 8254 입력 주파수를 TIMER_FREQ로 나눈 값, 즉 한 틱에 해당하는 카운트. */
+/* 8254 input frequency divided by TIMER_FREQ, rounded to
+   nearest: the PIT count that makes up one timer tick. */
+#define PIT_TICK_COUNT ((1193180 + TIMER_FREQ / 2) / TIMER_FREQ)
+
+/* 8254 카운터는 16비트이므로 한 번의 원샷으로 건너뛸 수 있는 최대 틱 수.
+   더 긴 유휴 구간은 원샷을 이어 붙여 채웁니다. */
+/* Most ticks one 16-bit one-shot count can cover.  Longer idle
+   periods are covered by chaining one-shots. */
+#define PIT_MAX_IDLE_TICKS (0xffff / PIT_TICK_COUNT)
+
+/* true면 유휴 상태에서 주기적 틱을 멈추고 원샷 타이머를 사용합니다.
+   커널 명령줄 옵션 "-tickless"에 의해 제어됩니다. */
+/* If true, stop the periodic tick while the CPU is idle and
+   program a one-shot timer for the next sleeper instead.
+   Controlled by kernel command-line option "-tickless". */
+bool timer_tickless;
+
+/* 원샷 모드로 프로그래밍된 틱 수. 주기 모드면 0. */
+/* Ticks the PIT is currently programmed to cover in one-shot
+   mode, or 0 while it runs in periodic mode. */
+static int64_t oneshot_ticks;
+
+/* 유휴 구간이 끝나야 하는 틱. 이어 붙인 원샷은 이 시각까지 갑니다. */
+/* Tick at which the current tickless idle period ends.  Chained
+   one-shots run up to it. */
+static int64_t idle_until;
+
+/* 통계. */
+/* Statistics. */
+static int64_t skipped_ticks;   /* 유휴 상태에서 건너뛴 틱 수. */ /* # of ticks skipped while idle. */
+static int64_t tickless_idles;  /* 원샷으로 들어간 유휴 구간 수. */ /* # of one-shot idle periods. */
+
 /* 타이머 틱당 루프 수. timer_calibrate() 함수에 의해 초기화됩니다. */
 /* Number of loops per timer tick.
    Initialized by timer_calibrate(). */
@@ -33,6 +67,9 @@ static intr_handler_func timer_interrupt;
 static bool too_many_loops(unsigned loops);
 static void busy_wait(int64_t loops);
 static void real_time_sleep(int64_t num, int32_t denom);
+static void pit_program(uint8_t mode, uint16_t count);
+static void oneshot_arm(void);
+static void idle_credit(int64_t);
 
 /* 8254 프로그래머블 인터벌 타이머(PIT)를 설정하여
    초당 PIT_FREQ 회 인터럽트가 발생하도록 하고,
@@ -41,14 +78,7 @@ static void real_time_sleep(int64_t num, int32_t denom);
    interrupt PIT_FREQ times per second, and registers the
    corresponding interrupt. */
 void timer_init(void) {
-    /* 8254 입력 주파수를 TIMER_FREQ로 나눈 후, 가장 가까운 값으로 반올림합니다. */
-    /* 8254 input frequency divided by TIMER_FREQ, rounded to
-       nearest. */
-    uint16_t count = (1193180 + TIMER_FREQ / 2) / TIMER_FREQ;
-
-    outb(0x43, 0x34); /* CW: counter 0, LSB then MSB, mode 2, binary. */ /* CW: 카운터 0, LSB 후 MSB, 모드 2, 이진형식. */
-    outb(0x40, count & 0xff);
-    outb(0x40, count >> 8);
+    pit_program(2, PIT_TICK_COUNT);
 
     intr_register_ext(0x20, timer_interrupt, "8254 Timer");
 }
@@ -130,16 +160,155 @@ void timer_nsleep(int64_t ns) {
 /* Prints timer statistics. */
 void timer_print_stats(void) {
     printf("Timer: %" PRId64 " ticks\n", timer_ticks());
+    if (timer_tickless)
+        printf("Timer: %" PRId64 " ticks skipped in %" PRId64 " tickless idle periods\n", skipped_ticks, tickless_idles);
+}
+
+/* 유휴 스레드가 hlt 직전에 인터럽트를 끈 상태로 호출합니다.
+   타이머가 다음에 할 일이 있는 시각까지 주기적 틱을 멈추고 원샷 타이머를 겁니다. */
+/* Called by the idle thread, with interrupts off, right before
+   it halts.  If the timer's next event (see thread_next_event())
+   is more than one tick away, reprograms the PIT to fire once at
+   that tick instead of every tick, chaining one-shots if it is
+   more than PIT_MAX_IDLE_TICKS away. */
+void timer_idle_enter(void) {
+    int64_t next;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    /* MLFQS는 매 초의 load_avg 갱신을 위해 모든 틱이 필요합니다. */
+    /* The MLFQS needs every tick for its once-per-second update. */
+    if (!timer_tickless || thread_mlfqs || oneshot_ticks != 0)
+        return;
+
+    next = thread_next_event();
+    if (next - ticks <= 1)
+        return;
+
+    idle_until = next;
+    tickless_idles++;
+    oneshot_arm();
+}
+
+/* 원샷 타이머가 아직 유휴 구간을 세고 있으면 true를 반환합니다.
+   유휴 스레드는 hlt에서 깨어났을 때 이것이 참이고 준비된 스레드가 없으면
+   다시 hlt합니다. */
+/* Returns true if a one-shot is still counting out the idle
+   period.  If so and no thread is ready, the idle thread halts
+   again instead of leaving the idle period. */
+bool timer_idle_armed(void) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    return oneshot_ticks != 0;
+}
+
+/* 유휴 스레드가 hlt에서 깨어난 뒤 인터럽트를 끈 상태로 호출합니다.
+   원샷이 끝나기 전에 다른 인터럽트로 깨어났다면, 지나간 틱만큼 ticks를
+   보정하고 주기 모드로 되돌립니다. */
+/* Called by the idle thread, with interrupts off, after it
+   wakes from halt.  If some other interrupt woke the CPU before
+   the one-shot expired, credits the ticks that actually elapsed
+   and returns the PIT to periodic mode. */
+void timer_idle_exit(void) {
+    uint16_t remaining;
+    int64_t elapsed;
+    uint8_t status;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (oneshot_ticks == 0)
+        return;
+
+    /* Read-back: 카운터 0의 상태와 카운트를 래치합니다. */
+    /* Read-back command: latch status and count of counter 0. */
+    outb(0x43, 0xc2);
+    status = inb(0x40);
+    remaining = inb(0x40);
+    remaining |= inb(0x40) << 8;
+
+    if (status & 0x80) {
+        /* OUT 핀이 이미 올라갔으므로 타이머 인터럽트가 대기 중입니다.
+           마지막 한 틱은 그 인터럽트가 세도록 남겨 둡니다. */
+        /* OUT is already high, so the expiry interrupt is pending
+           and will count the final tick itself. */
+        elapsed = oneshot_ticks - 1;
+    } else
+        elapsed = (oneshot_ticks * PIT_TICK_COUNT - remaining) / PIT_TICK_COUNT;
+
+    oneshot_ticks = 0;
+    idle_until = 0;
+    pit_program(2, PIT_TICK_COUNT);
+    idle_credit(elapsed);
+    thread_wakeup(ticks);
 }
 
 /* 타이머 인터럽트 핸들러입니다. */
 /* Timer interrupt handler. */
-static void timer_interrupt(struct intr_frame *args UNUSED) {
+static void timer_interrupt(struct intr_frame *args) {
+    if (oneshot_ticks != 0) {
+        if (idle_until - (ticks + oneshot_ticks) > 1) {
+            /* 유휴 구간의 중간 원샷이 만료되었습니다. 다음 원샷을 이어 겁니다.
+               그 사이에는 타이머가 할 일이 없으므로 thread_tick()을 건너뜁니다. */
+            /* A one-shot short of the end of the idle period
+               expired: chain the next one.  The timer has nothing
+               to do before idle_until, so thread_tick() is skipped
+               and every elapsed tick is idle time. */
+            idle_credit(oneshot_ticks);
+            oneshot_arm();
+            return;
+        }
+
+        /* 마지막 원샷이 만료되었습니다. 건너뛴 틱을 반영하고 주기 모드로 복귀합니다.
+           마지막 한 틱은 아래에서 평소처럼 셉니다. */
+        /* The last one-shot expired: account for the skipped
+           ticks and go back to periodic mode.  The final tick is
+           counted below as usual. */
+        idle_credit(oneshot_ticks - 1);
+        oneshot_ticks = 0;
+        idle_until = 0;
+        pit_program(2, PIT_TICK_COUNT);
+    }
     ticks++;
-    thread_tick();
+    if (profile_interval != 0)
+        profile_sample(args);
+    thread_tick((args->cs & 3) == 3);
     thread_wakeup(ticks);
 }
 
+/* idle_until까지 남은 틱을, 최대 PIT_MAX_IDLE_TICKS까지 세는 원샷을 겁니다. */
+/* Programs a one-shot for the ticks left until idle_until, at
+   most PIT_MAX_IDLE_TICKS of them. */
+static void oneshot_arm(void) {
+    int64_t delta = idle_until - ticks;
+
+    ASSERT(delta > 1);
+    if (delta > PIT_MAX_IDLE_TICKS)
+        delta = PIT_MAX_IDLE_TICKS;
+    oneshot_ticks = delta;
+    pit_program(0, delta * PIT_TICK_COUNT);
+}
+
+/* 유휴 상태에서 틱 인터럽트 없이 지나간 틱 CNT개를 ticks와 CPU의 유휴 시간에 더합니다. */
+/* Accounts for CNT ticks that went by idle without a timer
+   interrupt, both in ticks and in the CPU's idle time. */
+static void idle_credit(int64_t cnt) {
+    ticks += cnt;
+    skipped_ticks += cnt;
+    this_cpu()->idle_ticks += cnt;
+}
+
+/* 8254의 카운터 0을 MODE로 설정하고 COUNT를 적재합니다.
+   모드 2는 주기적 틱, 모드 0은 원샷(종료 카운트에서 인터럽트)입니다. */
+/* Programs 8254 counter 0 in MODE with COUNT.  Mode 2 is the
+   periodic rate generator, mode 0 interrupts once on terminal
+   count. */
+static void pit_program(uint8_t mode, uint16_t count) {
+    /* CW: counter 0, LSB then MSB, MODE, binary. */ /* CW: 카운터 0, LSB 후 MSB, MODE, 이진형식. */
+    outb(0x43, 0x30 | (mode << 1));
+    outb(0x40, count & 0xff);
+    outb(0x40, count >> 8);
+}
+
 /* 지정된 루프 반복 횟수가 한 타이머 틱을 초과하는 경우 true를 반환합니다. */
 /* Returns true if LOOPS iterations waits for more than one timer
    tick, otherwise false. */
@@ -2,28 +2,45 @@
 #include <debug.h>
 #include "filesys/inode.h"
 #include "threads/malloc.h"
+#include "threads/synch.h"
 
-/* An open file. */
+/* An open file.  Threads of a process share its open files, and
+ * callers may hold filesys_lock only for reading, so POS is
+ * protected by a lock of its own. */
 struct file {
 	struct inode *inode;        /* File's inode. */
+	struct lock pos_lock;       /* Protects POS. */
 	off_t pos;                  /* Current position. */
 	bool deny_write;            /* Has file_deny_write() been called? */
 };
 
+/* Cache that open files are allocated from.  A free file has
+ * DENY_WRITE false, as file_close() allows writes first, and an
+ * initialized POS_LOCK that nobody holds. */
+static struct kmem_cache *file_cache;
+
+static void file_ctor (void *);
+
+/* Initializes the file module. */
+void
+file_init (void) {
+	file_cache = kmem_cache_create ("file", sizeof (struct file), file_ctor);
+	if (file_cache == NULL)
+		PANIC ("file cache creation failed");
+}
+
 /* Opens a file for the given INODE, of which it takes ownership,
  * and returns the new file.  Returns a null pointer if an
  * allocation fails or if INODE is null. */
 struct file *
 file_open (struct inode *inode) {
-	struct file *file = calloc (1, sizeof *file);
-	if (inode != NULL && file != NULL) {
+	struct file *file = inode != NULL ? kmem_cache_alloc (file_cache) : NULL;
+	if (file != NULL) {
 		file->inode = inode;
 		file->pos = 0;
-		file->deny_write = false;
 		return file;
 	} else {
 		inode_close (inode);
-		free (file);
 		return NULL;
 	}
 }
@@ -41,7 +58,7 @@ struct file *
 file_duplicate (struct file *file) {
 	struct file *nfile = file_open (inode_reopen (file->inode));
 	if (nfile) {
-		nfile->pos = file->pos;
+		nfile->pos = file_tell (file);
 		if (file->deny_write)
 			file_deny_write (nfile);
 	}
@@ -54,7 +71,7 @@ file_close (struct file *file) {
 	if (file != NULL) {
 		file_allow_write (file);
 		inode_close (file->inode);
-		free (file);
+		kmem_cache_free (file_cache, file);
 	}
 }
 
@@ -71,8 +88,12 @@ file_get_inode (struct file *file) {
  * Advances FILE's position by the number of bytes read. */
 off_t
 file_read (struct file *file, void *buffer, off_t size) {
-	off_t bytes_read = inode_read_at (file->inode, buffer, size, file->pos);
+	off_t bytes_read;
+
+	lock_acquire (&file->pos_lock);
+	bytes_read = inode_read_at (file->inode, buffer, size, file->pos);
 	file->pos += bytes_read;
+	lock_release (&file->pos_lock);
 	return bytes_read;
 }
 
@@ -95,8 +116,12 @@ file_read_at (struct file *file, void *buffer, off_t size, off_t file_ofs) {
  * Advances FILE's position by the number of bytes read. */
 off_t
 file_write (struct file *file, const void *buffer, off_t size) {
-	off_t bytes_written = inode_write_at (file->inode, buffer, size, file->pos);
+	off_t bytes_written;
+
+	lock_acquire (&file->pos_lock);
+	bytes_written = inode_write_at (file->inode, buffer, size, file->pos);
 	file->pos += bytes_written;
+	lock_release (&file->pos_lock);
 	return bytes_written;
 }
 
@@ -149,13 +174,29 @@ void
 file_seek (struct file *file, off_t new_pos) {
 	ASSERT (file != NULL);
 	ASSERT (new_pos >= 0);
+	lock_acquire (&file->pos_lock);
 	file->pos = new_pos;
+	lock_release (&file->pos_lock);
 }
 
 /* Returns the current position in FILE as a byte offset from the
  * start of the file. */
 off_t
 file_tell (struct file *file) {
+	off_t pos;
+
 	ASSERT (file != NULL);
-	return file->pos;
+	lock_acquire (&file->pos_lock);
+	pos = file->pos;
+	lock_release (&file->pos_lock);
+	return pos;
+}
+
+/* Constructs a free file. */
+static void
+file_ctor (void *file_) {
+	struct file *file = file_;
+
+	lock_init (&file->pos_lock);
+	file->deny_write = false;
 }
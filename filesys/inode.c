@@ -6,6 +6,7 @@
 #include "filesys/filesys.h"
 #include "filesys/free-map.h"
 #include "threads/malloc.h"
+#include "threads/synch.h"
 
 /* Identifies an inode. */
 #define INODE_MAGIC 0x494e4f44
@@ -53,10 +54,22 @@ byte_to_sector (const struct inode *inode, off_t pos) {
  * returns the same `struct inode'. */
 static struct list open_inodes;
 
+/* Protects OPEN_INODES and the open counts of its members, so
+ * that readers of the file system, which may run concurrently
+ * under filesys_lock, can open inodes. */
+static struct lock open_inodes_lock;
+
+/* Cache that struct inodes are allocated from. */
+static struct kmem_cache *inode_cache;
+
 /* Initializes the inode module. */
 void
 inode_init (void) {
+	inode_cache = kmem_cache_create ("inode", sizeof (struct inode), NULL);
+	if (inode_cache == NULL)
+		PANIC ("inode cache creation failed");
 	list_init (&open_inodes);
+	lock_init (&open_inodes_lock);
 }
 
 /* Initializes an inode with LENGTH bytes of data and
@@ -105,19 +118,23 @@ inode_open (disk_sector_t sector) {
 	struct inode *inode;
 
 	/* Check whether this inode is already open. */
+	lock_acquire (&open_inodes_lock);
 	for (e = list_begin (&open_inodes); e != list_end (&open_inodes);
 			e = list_next (e)) {
 		inode = list_entry (e, struct inode, elem);
 		if (inode->sector == sector) {
-			inode_reopen (inode);
+			inode->open_cnt++;
+			lock_release (&open_inodes_lock);
 			return inode; 
 		}
 	}
 
 	/* Allocate memory. */
-	inode = malloc (sizeof *inode);
-	if (inode == NULL)
+	inode = kmem_cache_alloc (inode_cache);
+	if (inode == NULL) {
+		lock_release (&open_inodes_lock);
 		return NULL;
+	}
 
 	/* Initialize. */
 	list_push_front (&open_inodes, &inode->elem);
@@ -126,14 +143,18 @@ inode_open (disk_sector_t sector) {
 	inode->deny_write_cnt = 0;
 	inode->removed = false;
 	disk_read (filesys_disk, inode->sector, &inode->data);
+	lock_release (&open_inodes_lock);
 	return inode;
 }
 
 /* Reopens and returns INODE. */
 struct inode *
 inode_reopen (struct inode *inode) {
-	if (inode != NULL)
+	if (inode != NULL) {
+		lock_acquire (&open_inodes_lock);
 		inode->open_cnt++;
+		lock_release (&open_inodes_lock);
+	}
 	return inode;
 }
 
@@ -153,9 +174,11 @@ inode_close (struct inode *inode) {
 		return;
 
 	/* Release resources if this was the last opener. */
+	lock_acquire (&open_inodes_lock);
 	if (--inode->open_cnt == 0) {
 		/* Remove from inode list and release lock. */
 		list_remove (&inode->elem);
+		lock_release (&open_inodes_lock);
 
 		/* Deallocate blocks if removed. */
 		if (inode->removed) {
@@ -164,8 +187,9 @@ inode_close (struct inode *inode) {
 					bytes_to_sectors (inode->data.length)); 
 		}
 
-		free (inode); 
-	}
+		kmem_cache_free (inode_cache, inode);
+	} else
+		lock_release (&open_inodes_lock);
 }
 
 /* Marks INODE to be deleted when it is closed by the last caller who
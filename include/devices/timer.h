@@ -2,6 +2,7 @@
 #define DEVICES_TIMER_H
 
 #include <round.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Number of timer interrupts per second. */
@@ -20,4 +21,10 @@ void timer_nsleep (int64_t nanoseconds);
 
 void timer_print_stats (void);
 
+/* Dynamic tick. */
+extern bool timer_tickless;
+void timer_idle_enter (void);
+void timer_idle_exit (void);
+bool timer_idle_armed (void);
+
 #endif /* devices/timer.h */
@@ -0,0 +1,9 @@
+#ifndef __LIB_FUTEX_H
+#define __LIB_FUTEX_H
+
+/* Results of futex_wait. */
+#define FUTEX_WOKEN 0           /* Woken up by futex_wake. */
+#define FUTEX_CHANGED 1         /* *ADDR did not hold EXPECTED. */
+#define FUTEX_TIMEDOUT 2        /* The timeout ran out first. */
+
+#endif /* lib/futex.h */
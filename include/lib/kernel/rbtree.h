@@ -0,0 +1,68 @@
+#ifndef __LIB_KERNEL_RBTREE_H
+#define __LIB_KERNEL_RBTREE_H
+
+/* Red-black tree.
+ *
+ * A balanced binary search tree ordered by a caller-supplied
+ * LESS function.  Insertion and removal are O(log n) worst case.
+ * The least element is cached, so rb_first() is O(1).  Elements
+ * that compare equal are kept in insertion order.
+ *
+ * Like the linked list and the hash table, the tree does not use
+ * dynamic allocation.  Each structure that can potentially be in
+ * a tree must embed a struct rb_node member, and rb_entry()
+ * converts a struct rb_node back to the structure that contains
+ * it.  Refer to lib/kernel/list.h for a detailed explanation of
+ * the technique. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tree node. */
+struct rb_node {
+	struct rb_node *parent;     /* Parent, or NULL at the root. */
+	struct rb_node *left;       /* Left child. */
+	struct rb_node *right;      /* Right child. */
+	bool red;                   /* Red or black. */
+};
+
+/* Converts pointer to tree node RB_NODE into a pointer to the
+ * structure that RB_NODE is embedded inside.  Supply the name of
+ * the outer structure STRUCT and the member name MEMBER of the
+ * tree node. */
+#define rb_entry(RB_NODE, STRUCT, MEMBER)               \
+	((STRUCT *) ((uint8_t *) &(RB_NODE)->parent     \
+		- offsetof (STRUCT, MEMBER.parent)))
+
+/* Compares the value of two tree nodes A and B, given auxiliary
+ * data AUX.  Returns true if A is less than B, or false if A is
+ * greater than or equal to B. */
+typedef bool rb_less_func (const struct rb_node *a,
+		const struct rb_node *b,
+		void *aux);
+
+/* Red-black tree. */
+struct rb_tree {
+	struct rb_node *root;       /* Root, or NULL if empty. */
+	struct rb_node *first;      /* Least node, or NULL if empty. */
+	size_t node_cnt;            /* Number of nodes in tree. */
+	rb_less_func *less;         /* Comparison function. */
+	void *aux;                  /* Auxiliary data for `less'. */
+};
+
+void rb_init (struct rb_tree *, rb_less_func *, void *aux);
+
+/* Insertion and deletion. */
+void rb_insert (struct rb_tree *, struct rb_node *);
+void rb_remove (struct rb_tree *, struct rb_node *);
+
+/* Traversal. */
+struct rb_node *rb_first (const struct rb_tree *);
+struct rb_node *rb_next (const struct rb_node *);
+
+/* Information. */
+size_t rb_size (const struct rb_tree *);
+bool rb_empty (const struct rb_tree *);
+
+#endif /* lib/kernel/rbtree.h */
@@ -0,0 +1,20 @@
+#ifndef __LIB_RUSAGE_H
+#define __LIB_RUSAGE_H
+
+/* Resource usage, as reported by the getrusage system call.
+   Times are in timer ticks. */
+struct rusage {
+	long long utime;            /* Ticks spent in user mode. */
+	long long stime;            /* Ticks spent in the kernel. */
+	long long nvcsw;            /* Voluntary context switches. */
+	long long nivcsw;           /* Involuntary context switches. */
+	long long page_faults;      /* Page faults taken. */
+	long long sectors_read;     /* Disk sectors read. */
+	long long sectors_written;  /* Disk sectors written. */
+};
+
+/* Whose usage getrusage reports. */
+#define RUSAGE_SELF 0           /* The calling thread. */
+#define RUSAGE_CHILDREN (-1)    /* Its children that have been waited for. */
+
+#endif /* lib/rusage.h */
@@ -36,6 +36,24 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* Scheduling. */
+	SYS_SET_DEADLINE,           /* Join or leave the EDF class. */
+	SYS_CPU_GROUP_CREATE,       /* Create a CPU bandwidth group. */
+	SYS_CPU_GROUP_JOIN,         /* Move into a CPU bandwidth group. */
+	SYS_CPU_GROUP_USAGE,        /* Report a group's CPU usage. */
+
+	/* Accounting. */
+	SYS_GETRUSAGE,              /* Report resource usage. */
+
+	/* Synchronization. */
+	SYS_FUTEX_WAIT,             /* Sleep while a word holds a value. */
+	SYS_FUTEX_WAKE,             /* Wake threads sleeping on a word. */
+
+	/* Threads. */
+	SYS_CLONE,                  /* Add a thread to this process. */
+	SYS_JOIN,                   /* Wait for a thread to end. */
+	SYS_EXIT_THREAD,            /* End this thread only. */
 };
 
 #endif /* lib/syscall-nr.h */
@@ -4,11 +4,17 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <stddef.h>
+#include <rusage.h>
+#include <futex.h>
 
 /* Process identifier. */
 typedef int pid_t;
 #define PID_ERROR ((pid_t) -1)
 
+/* Thread identifier. */
+typedef int tid_t;
+#define TID_ERROR ((tid_t) -1)
+
 /* Map region identifier. */
 typedef int off_t;
 #define MAP_FAILED ((void *) NULL)
@@ -38,6 +44,24 @@ void close (int fd);
 
 int dup2(int oldfd, int newfd);
 
+/* Scheduling. */
+bool set_deadline (unsigned runtime, unsigned period);
+int cpu_group_create (unsigned quota, unsigned period);
+bool cpu_group_join (int group);
+bool cpu_group_usage (int group, long long *consumed, long long *throttled);
+
+/* Accounting. */
+int getrusage (int who, struct rusage *usage);
+
+/* Synchronization. */
+int futex_wait (int *addr, int expected, int timeout);
+int futex_wake (int *addr, int n);
+
+/* Threads. */
+tid_t clone (void (*fn) (void *), void *arg, void *stack);
+int join (tid_t);
+void exit_thread (int status) NO_RETURN;
+
 /* Project 3 and optionally project 4. */
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
 void munmap (void *addr);
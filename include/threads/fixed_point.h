@@ -0,0 +1,69 @@
+#ifndef THREADS_FIXED_POINT_H
+#define THREADS_FIXED_POINT_H
+
+#include <stdint.h>
+
+/* 17.14 고정소수점 실수. 커널은 부동소수점을 쓸 수 없으므로
+   MLFQS의 load_avg와 recent_cpu 계산에 사용합니다. */
+/* 17.14 fixed-point real numbers.  The kernel cannot use the
+   FPU, so the MLFQS keeps load_avg and recent_cpu in this
+   format.  The low FP_Q bits hold the fraction. */
+typedef int fixed_t;
+
+#define FP_Q 14
+#define FP_F (1 << FP_Q)
+
+/* 정수 N을 고정소수점으로 변환합니다. */
+/* Converts integer N to fixed point. */
+static inline fixed_t fp_from_int(int n) {
+    return n * FP_F;
+}
+
+/* X를 0 방향으로 버림하여 정수로 변환합니다. */
+/* Converts X to integer, rounding toward zero. */
+static inline int fp_to_int(fixed_t x) {
+    return x / FP_F;
+}
+
+/* X를 가장 가까운 정수로 반올림합니다. */
+/* Converts X to integer, rounding to nearest. */
+static inline int fp_round(fixed_t x) {
+    return x >= 0 ? (x + FP_F / 2) / FP_F : (x - FP_F / 2) / FP_F;
+}
+
+static inline fixed_t fp_add(fixed_t x, fixed_t y) {
+    return x + y;
+}
+
+static inline fixed_t fp_sub(fixed_t x, fixed_t y) {
+    return x - y;
+}
+
+static inline fixed_t fp_add_int(fixed_t x, int n) {
+    return x + n * FP_F;
+}
+
+static inline fixed_t fp_sub_int(fixed_t x, int n) {
+    return x - n * FP_F;
+}
+
+/* 곱셈과 나눗셈은 중간값이 넘치지 않도록 64비트로 계산합니다. */
+/* Multiplication and division go through 64 bits so the
+   intermediate value cannot overflow. */
+static inline fixed_t fp_mul(fixed_t x, fixed_t y) {
+    return (fixed_t)(((int64_t)x) * y / FP_F);
+}
+
+static inline fixed_t fp_mul_int(fixed_t x, int n) {
+    return x * n;
+}
+
+static inline fixed_t fp_div(fixed_t x, fixed_t y) {
+    return (fixed_t)(((int64_t)x) * FP_F / y);
+}
+
+static inline fixed_t fp_div_int(fixed_t x, int n) {
+    return x / n;
+}
+
+#endif /* threads/fixed_point.h */
@@ -75,4 +75,10 @@ void intr_yield_on_return (void);
 void intr_dump_frame (const struct intr_frame *);
 const char *intr_name (uint8_t vec);
 
+/* 인터럽트가 꺼져 있던 구간 추적. */
+/* Interrupts-off tracing. */
+extern bool intr_trace_enabled;
+void intr_trace_stop (void);
+void intr_print_stats (void);
+
 #endif /* threads/interrupt.h */
@@ -0,0 +1,22 @@
+#ifndef THREADS_LOCKPROF_H
+#define THREADS_LOCKPROF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 락 경합 프로파일러. DEFINES에 -DLOCK_PROFILE을 넣어 빌드할 때만 존재합니다.
+   락, 읽기-쓰기 락, 스핀락을 기록합니다. */
+/* Lock contention profiler.  Only built with -DLOCK_PROFILE in
+   DEFINES.  Records locks, reader-writer locks and spinlocks. */
+#ifdef LOCK_PROFILE
+struct lock_prof;
+
+struct lock_prof *lock_prof_register (const void *lock, const char *kind,
+                                      const char *name);
+void lock_prof_acquired (struct lock_prof *, bool contended, uint64_t wait,
+                         void *caller);
+void lock_prof_released (struct lock_prof *, uint64_t hold);
+void lock_print_stats (void);
+#endif
+
+#endif /* threads/lockprof.h */
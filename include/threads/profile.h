@@ -0,0 +1,47 @@
+#ifndef THREADS_PROFILE_H
+#define THREADS_PROFILE_H
+
+#include <stdint.h>
+
+struct intr_frame;
+
+/* 표본 추출 프로파일러. 커널 명령줄 옵션 "-profile=N"으로 켜며, N 타이머 틱마다
+   하나씩 표본을 남깁니다. 0이면 꺼져 있습니다. */
+/* Sampling profiler, turned on by kernel command-line option
+   "-profile=N": one sample every N timer ticks.  Off if 0. */
+extern int profile_interval;
+
+/* 표본 하나가 기억하는 주소의 최대 수. */
+/* Most addresses a sample holds. */
+#define PROFILE_DEPTH 8
+
+/* 표본 하나. 이 형식 그대로 파일에 저장됩니다. */
+/* A sample.  Saved to disk as is. */
+struct profile_sample {
+	int32_t tid;                /* 실행 중이던 스레드. *//* Running thread. */
+	uint8_t user;               /* PC[0]이 사용자 주소면 1. *//* 1 if PC[0] is a user address. */
+	uint8_t depth;              /* PC의 항목 수. *//* # of entries in PC. */
+	uint16_t pad;
+	uint64_t pc[PROFILE_DEPTH]; /* 중단된 rip, 그다음 반환 주소들, 안쪽부터. *//* Interrupted rip, then return addresses, innermost first. */
+};
+
+/* 저장된 프로파일 파일의 머리. 뒤에 SAMPLE_CNT개의 struct profile_sample이 이어집니다. */
+/* Header of a saved profile, followed by SAMPLE_CNT struct
+   profile_samples in the order taken. */
+struct profile_header {
+	char magic[4];              /* "PROF". */
+	uint32_t sample_size;       /* sizeof (struct profile_sample). */
+	uint32_t sample_cnt;        /* 저장된 표본 수. *//* # of samples saved. */
+	uint32_t dropped;           /* 버퍼가 가득 차 버린 표본 수. *//* # of samples lost to a full buffer. */
+	uint32_t hz;                /* 초당 표본 수. *//* Samples per second. */
+	uint32_t pad;
+};
+
+void profile_init (void);
+void profile_sample (const struct intr_frame *);
+void profile_print_stats (void);
+#ifdef FILESYS
+void profile_save (char **argv);
+#endif
+
+#endif /* threads/profile.h */
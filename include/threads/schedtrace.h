@@ -0,0 +1,65 @@
+#ifndef THREADS_SCHEDTRACE_H
+#define THREADS_SCHEDTRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct thread;
+
+/* 스케줄러 추적. 커널 명령줄 옵션 "-schedtrace"로 켜며, 꺼져 있으면 기록하지 않습니다. */
+/* Scheduler tracing, turned on by kernel command-line option
+   "-schedtrace".  Nothing is recorded while it is off. */
+extern bool sched_trace_enabled;
+
+/* 사건 종류. */
+/* Event types. */
+enum sched_event_type {
+	SCHED_EV_SWITCH,            /* TID에서 OTHER로 전환. *//* Switch from TID to OTHER. */
+	SCHED_EV_WAKEUP,            /* OTHER가 TID를 깨움. *//* TID woken up by OTHER. */
+	SCHED_EV_BLOCK,             /* TID가 잠듦. *//* TID blocked. */
+	SCHED_EV_YIELD,             /* TID가 CPU를 양보하거나 선점됨. *//* TID yielded or was preempted. */
+	SCHED_EV_DONATE,            /* TID가 OTHER에게 PRIORITY를 기부. *//* TID donated PRIORITY to OTHER. */
+};
+
+/* 추적 버퍼의 항목. 이 형식 그대로 파일에 저장됩니다. */
+/* An entry in the trace buffer.  Saved to disk as is. */
+struct sched_event {
+	uint64_t tsc;               /* 타임스탬프 카운터. *//* Time-stamp counter. */
+	int32_t tid;                /* 주체 스레드. *//* Subject thread. */
+	int32_t other;              /* 상대 스레드, 없으면 0. *//* Other thread involved, or 0. */
+	uint8_t type;               /* enum sched_event_type. */
+	uint8_t cpu;                /* CPU 번호. *//* CPU number. */
+	uint8_t priority;           /* TID의 우선순위, 기부면 기부한 우선순위. *//* TID's priority, or the donated one. */
+	uint8_t pad;
+};
+
+/* 저장된 추적 파일의 머리. 뒤에 EVENT_CNT개의 struct sched_event가 오래된 순서로 이어집니다. */
+/* Header of a saved trace file, followed by EVENT_CNT struct
+   sched_events, oldest first. */
+struct sched_trace_header {
+	char magic[4];              /* "STRC". */
+	uint32_t event_size;        /* sizeof (struct sched_event). */
+	uint32_t event_cnt;         /* 저장된 사건 수. *//* # of events saved. */
+	uint32_t dropped;           /* 덮어써진 사건 수. *//* # of events overwritten. */
+	uint64_t tsc_hz;            /* 초당 TSC 증가량 추정치. *//* Estimated TSC ticks per second. */
+};
+
+void sched_trace_init (void);
+void sched_trace_record (enum sched_event_type, const struct thread *,
+                         const struct thread *other, int priority);
+void sched_trace_ready (struct thread *);
+void sched_trace_run (const struct thread *);
+void sched_trace_print_stats (void);
+#ifdef FILESYS
+void sched_trace_save (char **argv);
+#endif
+
+/* 추적이 켜져 있을 때만 사건을 기록합니다. */
+/* Records an event if tracing is on. */
+#define sched_trace(TYPE, T, OTHER, PRIORITY)                   \
+	do {                                                        \
+		if (sched_trace_enabled)                                \
+			sched_trace_record (TYPE, T, OTHER, PRIORITY);      \
+	} while (0)
+
+#endif /* threads/schedtrace.h */
@@ -0,0 +1,13 @@
+#ifndef THREADS_SWITCH_H
+#define THREADS_SWITCH_H
+
+#include <stdint.h>
+
+struct intr_frame;
+
+/* 커널 스레드 간 문맥 교환. switch.S를 참고하세요. */
+/* Kernel-to-kernel context switch.  See switch.S. */
+void switch_threads(uint64_t *cur_rsp, uint64_t next_rsp);
+void switch_entry(uint64_t *cur_rsp, struct intr_frame *tf);
+
+#endif /* threads/switch.h */
@@ -1,16 +1,72 @@
 #ifndef THREADS_SYNCH_H
 #define THREADS_SYNCH_H
 
+#include <heap.h>
 #include <list.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-extern struct lock filesys_lock;
+struct cpu;
+struct lock_prof;
+
+/* 스핀락입니다. 인터럽트가 꺼진 상태에서만 잡을 수 있으며, 잡은 동안 잠들 수 없습니다. */
+/* A spinlock.  May only be acquired with interrupts off, and
+   must not be held across anything that sleeps, except as
+   handed to thread_block_on(). */
+struct spinlock {
+	volatile unsigned locked;   /* 잠겨 있으면 1입니다. *//* 1 while held. */
+	struct cpu *cpu;            /* 잠금을 보유한 CPU입니다 (디버깅 용). *//* CPU holding lock (for debugging). */
+	const char *name;           /* 이름입니다 (디버깅 용). *//* Name (for debugging). */
+#ifdef LOCK_PROFILE
+	struct lock_prof *prof;     /* 경합 기록, 없으면 NULL입니다. *//* Contention record, or NULL. */
+	uint64_t acquired_tsc;      /* 획득한 시각입니다. *//* When it was acquired. */
+#endif
+};
+
+void spinlock_init (struct spinlock *, const char *name);
+void spinlock_acquire (struct spinlock *);
+void spinlock_release (struct spinlock *);
+bool spinlock_held (const struct spinlock *);
+
+struct thread;
+
+/* 우선순위 대기 큐입니다. 우선순위가 가장 높은 스레드가 먼저 나오고,
+   같은 우선순위 사이에서는 먼저 온 스레드가 먼저 나옵니다. */
+/* A priority wait queue.  Holds threads waiting for some event
+   and hands them out highest priority first, first come first
+   served among equals.  A waiter whose priority changes while
+   queued, by donation for instance, is repositioned by
+   wait_queue_update().  wait_queue_barrier() puts every later
+   arrival behind the threads already queued, whatever their
+   priorities.  All operations except wait_queue_update()
+   require the caller to hold GUARD, a spinlock owned by the
+   synchronization object that embeds the queue. */
+struct wait_queue {
+	struct heap waiters;        /* 대기 중인 스레드입니다. *//* Waiting threads. */
+	struct spinlock *guard;     /* 큐를 보호하는 락입니다. *//* Protects this queue. */
+	uint64_t next_seq;          /* 다음 도착 순서입니다. *//* Next arrival number. */
+	uint64_t tier;              /* 새로 온 스레드의 단계입니다. *//* Tier of new arrivals. */
+};
+
+/* wait_queue_flush()가 꺼낸 스레드마다 호출하는 함수입니다. */
+/* Called by wait_queue_flush() on each thread it removes. */
+typedef void wait_queue_func (struct thread *t, void *aux);
+
+void wait_queue_init (struct wait_queue *, struct spinlock *guard);
+void wait_queue_push (struct wait_queue *, struct thread *);
+struct thread *wait_queue_pop (struct wait_queue *);
+struct thread *wait_queue_top (const struct wait_queue *);
+void wait_queue_flush (struct wait_queue *, wait_queue_func *, void *aux);
+bool wait_queue_empty (const struct wait_queue *);
+void wait_queue_barrier (struct wait_queue *);
+void wait_queue_update (struct thread *);
 
 /* 세마포어입니다. */
 /* A counting semaphore. */
 struct semaphore {
 	unsigned value;             /* 현재 값입니다. *//* Current value. */
-	struct list waiters;        /* 대기 중인 스레드의 목록입니다. *//* List of waiting threads. */
+	struct wait_queue waiters;  /* 대기 중인 스레드입니다. *//* Waiting threads. */
+	struct spinlock guard;      /* VALUE와 WAITERS를 보호합니다. *//* Protects VALUE and WAITERS. */
 };
 
 void sema_init (struct semaphore *, unsigned value);
@@ -24,9 +80,20 @@ void sema_self_test (void);
 struct lock {
 	struct thread *holder;      /* 잠금을 보유한 스레드입니다 (디버깅 용). *//* Thread holding lock (for debugging). */
 	struct semaphore semaphore; /* 접근을 제어하는 이진 세마포어입니다. *//* Binary semaphore controlling access. */
+	struct heap donors;         /* 대기 중인 스레드, 우선순위 순입니다. *//* Waiting threads, by priority. */
+	struct heap_elem holder_elem; /* 보유자의 held_locks 요소입니다. *//* Element in holder's held_locks. */
+	const char *name;           /* 이름입니다 (디버깅 용). *//* Name (for debugging). */
+#ifdef LOCK_PROFILE
+	struct lock_prof *prof;     /* 경합 기록, 없으면 NULL입니다. *//* Contention record, or NULL. */
+	uint64_t acquired_tsc;      /* 획득한 시각입니다. *//* When the holder acquired it. */
+#endif
 };
 
-void lock_init (struct lock *);
+/* 이름을 따로 주지 않으면 LOCK 표현식 자체가 이름이 됩니다. */
+/* Unless a name is given, the LOCK expression itself serves
+   as the name. */
+#define lock_init(LOCK) lock_init_named (LOCK, #LOCK)
+void lock_init_named (struct lock *, const char *name);
 void lock_acquire (struct lock *);
 bool lock_try_acquire (struct lock *);
 void lock_release (struct lock *);
@@ -35,7 +102,8 @@ bool lock_held_by_current_thread (const struct lock *);
 /* 조건 변수입니다. */
 /* Condition variable. */
 struct condition {
-	struct list waiters;        /* 대기 중인 스레드의 목록입니다. *//* List of waiting threads. */
+	struct wait_queue waiters;  /* 대기 중인 스레드입니다. *//* Waiting threads. */
+	struct spinlock guard;      /* WAITERS를 보호합니다. *//* Protects WAITERS. */
 };
 
 void cond_init (struct condition *);
@@ -43,8 +111,31 @@ void cond_wait (struct condition *, struct lock *);
 void cond_signal (struct condition *, struct lock *);
 void cond_broadcast (struct condition *, struct lock *);
 
-/* 우선순위 비교 함수 */
-bool sema_compare_priority (struct list_elem *e1, struct list_elem *e2, void *aux);
+/* 읽기-쓰기 락입니다. 읽는 쪽은 여럿이 함께, 쓰는 쪽은 혼자 보유합니다. */
+/* Reader-writer lock.  Held by any number of readers at once,
+   or by a single writer. */
+struct rwlock {
+	int readers;                /* 보유 중인 읽는 쪽의 수입니다. *//* # of readers holding it. */
+	struct thread *writer;      /* 보유 중인 쓰는 쪽, 없으면 NULL입니다. *//* Writer holding it, or NULL. */
+	struct wait_queue waiters;  /* 대기 중인 스레드, 양쪽 모두입니다. *//* Waiting readers and writers. */
+	struct spinlock guard;      /* 위의 모든 것을 보호합니다. *//* Protects all of the above. */
+#ifdef LOCK_PROFILE
+	struct lock_prof *prof;     /* 경합 기록, 없으면 NULL입니다. *//* Contention record, or NULL. */
+	uint64_t write_tsc;         /* 쓰는 쪽이 획득한 시각입니다. *//* When the writer acquired it. */
+#endif
+};
+
+/* 이름을 따로 주지 않으면 RW 표현식 자체가 이름이 됩니다. */
+/* Unless a name is given, the RW expression itself serves as
+   the name. */
+#define rwlock_init(RW) rwlock_init_named (RW, #RW)
+void rwlock_init_named (struct rwlock *, const char *name);
+void rwlock_acquire_read (struct rwlock *);
+void rwlock_release_read (struct rwlock *);
+void rwlock_acquire_write (struct rwlock *);
+void rwlock_release_write (struct rwlock *);
+
+extern struct rwlock filesys_lock;
 
 /* 최적화 바리어입니다.
  *
@@ -1,11 +1,14 @@
 #ifndef THREADS_THREAD_H
 #define THREADS_THREAD_H
-#define USERPROG
 #include <debug.h>
+#include <heap.h>
+#include <rbtree.h>
 #include <list.h>
+#include <rusage.h>
 #include <stdint.h>
 #include "threads/synch.h"
 #include "threads/interrupt.h"
+#include "threads/fixed_point.h"
 
 // project2 syscall fdt
 // #define FDT_PAGES 3
@@ -36,6 +39,12 @@ typedef int tid_t;
 #define PRI_DEFAULT 31                  /* 기본 우선순위. *//* Default priority. */
 #define PRI_MAX 63                       /* 최대 우선순위. *//* Highest priority. */
 
+/* MLFQS nice 값. */
+/* MLFQS niceness. */
+#define NICE_MIN -20                    /* 가장 양보하지 않음. *//* Least willing to yield. */
+#define NICE_DEFAULT 0                  /* 기본 nice 값. *//* Default niceness. */
+#define NICE_MAX 20                     /* 가장 잘 양보함. *//* Most willing to yield. */
+
 
 /* 커널 스레드 또는 유저 프로세스의 구조체입니다.
  *
@@ -150,12 +159,50 @@ struct thread {
 	int init_priority;
 	
 	struct lock *wait_on_lock;
-	struct list donations;
-	struct list_elem donation_elem;
+	struct heap held_locks;             /* 보유한 락, 기부 우선순위 순 *//* Locks held, by donated priority. */
+	struct heap_elem donor_elem;        /* wait_on_lock의 기부자 힙 요소 *//* Element in wait_on_lock's donors. */
+
+	// mlfqs
+	int nice;
+	fixed_t recent_cpu;
+	int64_t decay_epoch;                /* 마지막으로 감쇠된 초. *//* Last second decayed for. */
+	struct list_elem all_elem;          /* all_list의 요소. *//* Element in all_list. */
+
+	// cfs
+	uint64_t vruntime;                  /* 가중치를 반영한 누적 실행 시간. *//* Weighted run time. */
+	struct rb_node cfs_node;            /* cfs_tree의 노드. *//* Node in cfs_tree. */
+
+	// edf: 주기 EDF_PERIOD마다 EDF_RUNTIME 틱을 보장받습니다. 시간 단위는 틱입니다.
+	int64_t edf_runtime;                /* 주기당 실행 시간, EDF가 아니면 0. *//* Runtime per period, 0 if not EDF. */
+	int64_t edf_period;                 /* 주기. *//* Period. */
+	int64_t edf_deadline;               /* 현재 작업의 절대 마감 시각. *//* Absolute deadline of current job. */
+	int64_t edf_budget;                 /* 이번 주기에 남은 실행 시간. *//* Runtime left in this period. */
+	int edf_misses;                     /* 놓친 마감 수. *//* # of deadlines missed. */
+	bool edf_throttled;                 /* 예산을 다 써서 edf_throttled에 있음. *//* Out of budget, in edf_throttled. */
+	struct heap_elem edf_elem;          /* edf_queue 또는 edf_throttled의 요소. *//* Element in edf_queue or edf_throttled. */
+
+	// CPU 대역폭 그룹
+	struct cpu_group *cpu_group;        /* 속한 그룹. *//* Group we are charged to. */
+	struct cpu_group *parked_on;        /* 멈춘 그룹에 세워져 있으면 그 그룹. *//* Throttled group we are parked on, if any. */
+
+	// 자원 사용량: 자신의 것과 기다려 준 자식들의 합
+	struct rusage rusage;               /* 이 스레드의 사용량. *//* This thread's usage. */
+	struct rusage child_rusage;         /* 회수한 자식들의 사용량. *//* Usage of children waited for. */
+
+	// 스케줄러 추적
+	uint64_t ready_tsc;                 /* 실행 가능해진 TSC 시각. *//* TSC when last made runnable. */
 
 	/* Shared between thread.c and synch.c. */
 	struct list_elem elem;              /* 리스트 요소. *//* List element. */
+	struct wait_queue *wait_queue;      /* 대기 중인 큐, 없으면 NULL. *//* Wait queue we are in, if any. */
+	struct heap_elem wait_elem;         /* wait_queue의 요소. *//* Element in wait_queue. */
+	uint64_t wait_seq;                  /* 같은 우선순위 사이의 도착 순서. *//* Arrival order among equals. */
+	uint64_t wait_tier;                 /* 우선순위보다 앞서는 단계. *//* Tier, ahead of priority. */
+	bool rwlock_writer;                 /* rwlock을 쓰려고 기다리는가? *//* Waiting on an rwlock to write? */
+
+	// alarm clock: sleep_heap에서 wakeup_ticks 기준으로 정렬
 	int64_t wakeup_ticks;
+	struct heap_elem sleep_elem;
 
 	// project 2: fdt
 	struct file **fdt; 
@@ -172,6 +219,12 @@ struct thread {
 	// project 2: fork
 	struct semaphore fork_sema;
 
+	// 사용자 스레드: 한 프로세스의 스레드들은 주 스레드의 pml4, spt, fdt를 함께 씁니다.
+	struct thread *leader;              /* 프로세스의 주 스레드, 주 스레드면 자신. *//* Main thread of our process; ourselves if main. */
+	struct list members;                /* 주 스레드만: join되지 않은 추가 스레드. *//* Main thread only: extra threads not joined. */
+	struct list_elem member_elem;       /* 주 스레드의 members 요소. *//* Element in leader's members. */
+	bool exiting;                       /* 주 스레드만: 프로세스 전체가 끝나는 중인가? *//* Main thread only: whole process exiting? */
+
 
 #ifdef USERPROG
 	/* Owned by userprog/process.c. */
@@ -184,10 +237,75 @@ struct thread {
 #endif
 
 	/* Owned by thread.c. */
-	struct intr_frame tf;               /* 문맥 교환을 위한 정보 *//* Information for switching */
+	struct intr_frame tf;               /* 첫 진입을 위한 프레임 *//* Frame for first entry. */
+	uint64_t switch_rsp;                /* 저장된 커널 문맥, 첫 진입 전에는 0 *//* Saved kernel context, 0 before first entry. */
 	unsigned magic;                     /* 스택 오버플로우 감지. *//* Detects stack overflow. */
 };
 
+/* CPU 대역폭 그룹, thread.c에 정의됩니다. 0번은 제한 없는 루트 그룹입니다. */
+/* CPU bandwidth group, defined in thread.c.  Group 0 is the
+   unlimited root. */
+struct cpu_group;
+#define CPU_GROUP_MAX 16                /* 동시에 존재할 수 있는 그룹 수. *//* Most groups at once. */
+
+/* CPU별 스케줄러 상태. 각 CPU는 자신의 실행 큐와 유휴 스레드를 가집니다.
+ * rq_lock은 실행 큐를 보호하며 schedule()을 지나는 동안 계속 잡혀 있다가
+ * 전환된 스레드 쪽에서 해제됩니다. */
+/* Per-CPU scheduler state.  Each CPU owns a run queue and an
+ * idle thread.  RQ_LOCK protects the run queue; it is held
+ * across schedule() and released by the thread switched to. */
+
+/* 이것은 SMP를 위한 뼈대일 뿐입니다. AP를 INIT/SIPI로 기동하는 트램펄린, LAPIC
+ * 매핑, CPU별 GDT/TSS가 없으므로 부트 CPU만 실행되고, this_cpu()는 늘 cpus[0]을
+ * 반환합니다. 인터럽트를 끄는 것만으로 보호하는 자료 구조도 남아 있으므로,
+ * NCPU_MAX를 늘리려면 그것들도 락으로 보호해야 합니다. */
+/* This is scaffolding for SMP only.  There is no INIT/SIPI
+ * trampoline to start application processors, no LAPIC mapping
+ * and no per-CPU GDT or TSS, so only the boot CPU runs and
+ * this_cpu() always returns cpus[0].  Some structures are still
+ * protected only by turning interrupts off and would need locks
+ * before NCPU_MAX could grow. */
+#define NCPU_MAX 1                      /* 지원하는 최대 CPU 수. *//* Most CPUs supported. */
+
+struct cpu {
+	int id;                             /* CPU 번호. *//* CPU number. */
+	struct spinlock rq_lock;            /* 실행 큐 락. *//* Run queue lock. */
+
+	/* 우선순위마다 FIFO 큐 하나. READY_BITMAP의 비트 N은 ready_queues[N]이 비어 있지 않음을 뜻합니다. */
+	/* One FIFO queue per priority level.  Bit N of READY_BITMAP
+	   is set iff ready_queues[N] is non-empty. */
+	struct list ready_queues[PRI_MAX + 1];
+	uint64_t ready_bitmap;
+	int ready_cnt;                      /* 준비 큐에 있는 스레드 수. *//* # of threads in ready_queues. */
+
+	/* -cfs에서는 우선순위 큐 대신 vruntime 순의 트리를 씁니다. */
+	/* Under -cfs, ready threads sit in a tree ordered by
+	   vruntime instead of in READY_QUEUES. */
+	struct rb_tree cfs_tree;
+	unsigned long cfs_weight;           /* cfs_tree 스레드들의 가중치 합. *//* Total weight in cfs_tree. */
+	uint64_t min_vruntime;              /* 단조 증가하는 vruntime 하한. *//* Monotonic vruntime floor. */
+	unsigned slice;                     /* 현재 스레드의 타임 슬라이스. *//* Current thread's time slice. */
+
+	/* 예산이 남은 EDF 스레드는 다른 모든 스레드보다 먼저, 마감이 이른 순서로 실행됩니다. */
+	/* EDF threads with budget left run ahead of everyone else,
+	   earliest deadline first. */
+	struct heap edf_queue;
+	struct heap edf_throttled;          /* 예산을 다 쓴 EDF 스레드, 마감 순. *//* EDF threads out of budget, by deadline. */
+	int edf_util;                       /* 허용된 EDF 이용률의 합, 천분율. *//* Admitted EDF utilization, per mille. */
+
+	struct thread *idle_thread;         /* 이 CPU의 유휴 스레드. *//* This CPU's idle thread. */
+	struct list destruction_req;        /* 스레드 파괴 요청 목록. *//* Thread destruction requests. */
+	unsigned thread_ticks;              /* 마지막 yield 이후 타이머 틱 수. *//* # of timer ticks since last yield. */
+
+	/* 통계. */
+	/* Statistics. */
+	long long idle_ticks;               /* 유휴 상태에서 보낸 타이머 틱 수. *//* # of timer ticks spent idle. */
+	long long kernel_ticks;             /* 커널 스레드에서 보낸 타이머 틱 수. *//* # of timer ticks in kernel threads. */
+	long long user_ticks;               /* 사용자 프로그램에서 보낸 타이머 틱 수. *//* # of timer ticks in user programs. */
+};
+
+struct cpu *this_cpu (void);
+
 /* false(기본값)인 경우, 라운드-로빈 스케줄러를 사용합니다.
    true인 경우, 다중 수준 피드백 큐 스케줄러를 사용합니다.
    커널 명령 줄 옵션 "-o mlfqs"에 의해 제어됩니다. */
@@ -196,20 +314,35 @@ struct thread {
    Controlled by kernel command-line option "-o mlfqs". */
 extern bool thread_mlfqs;
 
+/* true인 경우, 가중치 공정 스케줄러를 사용합니다.
+   커널 명령 줄 옵션 "-cfs"에 의해 제어됩니다. */
+/* If true, use the weighted fair scheduler.
+   Controlled by kernel command-line option "-cfs". */
+extern bool thread_cfs;
+
 void thread_init (void);
 void thread_start (void);
 
-void thread_sleep(int64_t ticks) ;
-void next_awake_ticks(int64_t ticks);
+void thread_sleep(int64_t ticks);
+void thread_sleep_on(struct spinlock *guard, int64_t ticks);
+void thread_wake_sleeper(struct thread *);
+int64_t thread_next_event(void);
 void thread_wakeup(int64_t ticks);
 
-void thread_tick (void);
+void thread_tick (bool user);
 void thread_print_stats (void);
 
 typedef void thread_func (void *aux);
 tid_t thread_create (const char *name, int priority, thread_func *, void *);
 
+void thread_fdt_free (struct thread *);
+
+void thread_rusage_collect (struct thread *child);
+void thread_rusage_absorb (struct thread *member);
+void thread_rusage_process (bool children, struct rusage *);
+
 void thread_block (void);
+void thread_block_on (struct spinlock *);
 void thread_unblock (struct thread *);
 
 struct thread *thread_current (void);
@@ -222,14 +355,22 @@ void thread_yield (void);
 int thread_get_priority (void);
 void thread_set_priority (int);
 
-bool less_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
-bool more_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
 void test_max_priority(void);
+void thread_update_priority(struct thread *t, int priority);
 
 // donation 우선순위 비교
-bool thread_compare_donate_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
+bool thread_donor_less(const struct heap_elem *, const struct heap_elem *, void *aux);
 void donate_priority(void);
-void remove_with_lock(struct lock *lock);
+void refresh_priority(void);
+
+bool thread_set_deadline (int64_t runtime, int64_t period);
+bool thread_edf_next_period (void);
+int thread_get_deadline_misses (void);
+
+int thread_group_create (int parent, int64_t quota, int64_t period);
+bool thread_group_join (int id);
+int thread_group_current (void);
+bool thread_group_usage (int id, long long *consumed, long long *throttled);
 
 int thread_get_nice (void);
 void thread_set_nice (int);
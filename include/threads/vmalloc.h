@@ -0,0 +1,34 @@
+#ifndef THREADS_VMALLOC_H
+#define THREADS_VMALLOC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 커널 가상 주소 영역 할당자. 흩어진 물리 페이지를 연속된 커널 가상 주소 범위에
+   매핑하므로, 물리적으로 연속된 페이지가 없어도 큰 할당이 성공합니다. */
+/* Kernel virtual area allocator.  Maps scattered physical pages
+   into a contiguous range of kernel virtual addresses, so that
+   large allocations succeed without physically contiguous
+   pages. */
+
+/* 영역의 시작 주소와 페이지 수. 물리 메모리의 직접 매핑보다 위에 있으면서,
+   모든 pml4가 공유하는 커널 PML4 항목 안에 있습니다. */
+/* Start and size of the area.  It lies above the direct map of
+   physical memory, within the kernel PML4 entry that every
+   pml4 shares. */
+#define VMALLOC_BASE 0xc000000000
+#define VMALLOC_PAGES ((size_t) 1 << 18)
+#define VMALLOC_END (VMALLOC_BASE + VMALLOC_PAGES * 4096)
+
+/* VA가 vmalloc() 영역 안에 있으면 참입니다. */
+/* True if VA lies in the vmalloc() area. */
+#define is_vmalloc_vaddr(va) \
+    ((uint64_t)(va) >= VMALLOC_BASE && (uint64_t)(va) < VMALLOC_END)
+
+void vmalloc_init(uint64_t mem_end);
+void *vmalloc(size_t page_cnt);
+void vfree(void *);
+void vmalloc_print_stats(void);
+
+#endif /* threads/vmalloc.h */
@@ -0,0 +1,12 @@
+#ifndef USERPROG_FUTEX_H
+#define USERPROG_FUTEX_H
+
+#include <futex.h>
+#include <stdint.h>
+
+void futex_init(void);
+int futex_sleep(int *uaddr, int expected, int64_t timeout);
+int futex_wakeup(int *uaddr, int n);
+void futex_release(const void *as);
+
+#endif /* userprog/futex.h */
@@ -9,5 +9,9 @@ int process_exec (void *f_name);
 int process_wait (tid_t);
 void process_exit (void);
 void process_activate (struct thread *next);
+tid_t process_clone (void *entry, void *arg, void *stack);
+int process_join (tid_t);
+bool process_kill (int status);
+bool process_exiting (void);
 
 #endif /* userprog/process.h */
@@ -20,6 +20,9 @@ unsigned tell(int fd);
 void close (int fd);
 int wait (pid_t pid);
 int exec(const char *cmd_line);
+bool set_deadline(unsigned runtime, unsigned period);
+struct rusage;
+int getrusage(int who, struct rusage *usage);
 
 
 #endif /* userprog/syscall.h */
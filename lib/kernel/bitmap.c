@@ -3,6 +3,7 @@
 #include <limits.h>
 #include <round.h>
 #include <stdio.h>
+#include <string.h>
 #include "threads/malloc.h"
 #ifdef FILESYS
 #include "filesys/file.h"
@@ -23,10 +24,23 @@ typedef unsigned long elem_type;
 
 /* From the outside, a bitmap is an array of bits.  From the
    inside, it's an array of elem_type (defined above) that
-   simulates an array of bits. */
+   simulates an array of bits.
+
+   Searches go an element at a time, skipping elements that
+   cannot match and using ctz to find the matching bit within
+   one.  A second, summary level has one bit per element of
+   BITS, set iff that element has a bit set to false, so that a
+   search for false bits, the usual search for free space, skips
+   ELEM_BITS full elements per summary bit it reads.
+
+   The summary is updated after the element it describes, so it
+   stays exact only if updates to a bitmap are serialized, as
+   all its users do with a lock.  Single bits are still set
+   atomically. */
 struct bitmap {
 	size_t bit_cnt;     /* Number of bits. */
 	elem_type *bits;    /* Elements that represent bits. */
+	elem_type *summary; /* Bit K set iff BITS[K] has a false bit. */
 };
 
 /* Returns the index of the element that contains the bit
@@ -55,6 +69,13 @@ byte_cnt (size_t bit_cnt) {
 	return sizeof (elem_type) * elem_cnt (bit_cnt);
 }
 
+/* Returns the number of bytes required for the summary of
+   BIT_CNT bits. */
+static inline size_t
+summary_byte_cnt (size_t bit_cnt) {
+	return byte_cnt (elem_cnt (bit_cnt));
+}
+
 /* Returns a bit mask in which the bits actually used in the last
    element of B's bits are set to 1 and the rest are set to 0. */
 static inline elem_type
@@ -62,6 +83,84 @@ last_mask (const struct bitmap *b) {
 	int last_bits = b->bit_cnt % ELEM_BITS;
 	return last_bits ? ((elem_type) 1 << last_bits) - 1 : (elem_type) -1;
 }
+
+/* Returns a mask of the bits of element ELEM of B that are
+   bitmap bits START through END - 1, inclusive. */
+static inline elem_type
+range_mask (size_t elem, size_t start, size_t end) {
+	size_t lo = start > elem * ELEM_BITS ? start - elem * ELEM_BITS : 0;
+	size_t hi = end < (elem + 1) * ELEM_BITS ? end - elem * ELEM_BITS : ELEM_BITS;
+	elem_type mask = (elem_type) -1 << lo;
+
+	if (hi < ELEM_BITS)
+		mask &= ((elem_type) 1 << hi) - 1;
+	return mask;
+}
+
+/* Returns the number of bits set to 1 in BITS.  The kernel is
+   not linked with libgcc, so __builtin_popcount() is out. */
+static inline size_t
+elem_popcount (elem_type bits) {
+	bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+	bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+	bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (bits * 0x0101010101010101ULL) >> 56;
+}
+
+/* Brings the summary bit of element ELEM of B up to date. */
+static inline void
+summary_update (struct bitmap *b, size_t elem) {
+	elem_type valid = elem + 1 == elem_cnt (b->bit_cnt) ? last_mask (b) : (elem_type) -1;
+	elem_type mask = bit_mask (elem);
+
+	if ((b->bits[elem] & valid) != valid)
+		asm ("lock orq %1, %0" : "=m" (b->summary[elem_idx (elem)]) : "r" (mask) : "cc");
+	else
+		asm ("lock andq %1, %0" : "=m" (b->summary[elem_idx (elem)]) : "r" (~mask) : "cc");
+}
+
+/* Returns the index of the first element of B at or after ELEM
+   that has a false bit, or elem_cnt (B's bit count) if there is
+   none. */
+static size_t
+summary_next (const struct bitmap *b, size_t elem) {
+	size_t cnt = elem_cnt (b->bit_cnt);
+	size_t idx = elem_idx (elem);
+	elem_type bits;
+
+	if (elem >= cnt)
+		return cnt;
+	bits = b->summary[idx] & ((elem_type) -1 << (elem % ELEM_BITS));
+	while (bits == 0) {
+		if (++idx >= elem_cnt (cnt))
+			return cnt;
+		bits = b->summary[idx];
+	}
+	return idx * ELEM_BITS + __builtin_ctzl (bits);
+}
+
+/* Returns the index of the first bit in B from START up to END,
+   exclusive, that is set to VALUE, or END if there is none. */
+static size_t
+find_next (const struct bitmap *b, size_t start, size_t end, bool value) {
+	size_t elem = elem_idx (start);
+	elem_type bits;
+
+	if (start >= end)
+		return end;
+	bits = (value ? b->bits[elem] : ~b->bits[elem])
+		& ((elem_type) -1 << (start % ELEM_BITS));
+	while (bits == 0) {
+		elem++;
+		if (!value)
+			elem = summary_next (b, elem);
+		if (elem * ELEM_BITS >= end)
+			return end;
+		bits = value ? b->bits[elem] : ~b->bits[elem];
+	}
+	start = elem * ELEM_BITS + __builtin_ctzl (bits);
+	return start < end ? start : end;
+}
 
 /* Creation and destruction. */
 
@@ -74,8 +173,10 @@ bitmap_create (size_t bit_cnt) {
 	struct bitmap *b = malloc (sizeof *b);
 	if (b != NULL) {
 		b->bit_cnt = bit_cnt;
-		b->bits = malloc (byte_cnt (bit_cnt));
+		b->bits = malloc (byte_cnt (bit_cnt) + summary_byte_cnt (bit_cnt));
 		if (b->bits != NULL || bit_cnt == 0) {
+			b->summary = b->bits + elem_cnt (bit_cnt);
+			memset (b->summary, 0, summary_byte_cnt (bit_cnt));
 			bitmap_set_all (b, false);
 			return b;
 		}
@@ -95,6 +196,8 @@ bitmap_create_in_buf (size_t bit_cnt, void *block, size_t block_size UNUSED) {
 
 	b->bit_cnt = bit_cnt;
 	b->bits = (elem_type *) (b + 1);
+	b->summary = b->bits + elem_cnt (bit_cnt);
+	memset (b->summary, 0, summary_byte_cnt (bit_cnt));
 	bitmap_set_all (b, false);
 	return b;
 }
@@ -103,7 +206,7 @@ bitmap_create_in_buf (size_t bit_cnt, void *block, size_t block_size UNUSED) {
    with BIT_CNT bits (for use with bitmap_create_in_buf()). */
 size_t
 bitmap_buf_size (size_t bit_cnt) {
-	return sizeof (struct bitmap) + byte_cnt (bit_cnt);
+	return sizeof (struct bitmap) + byte_cnt (bit_cnt) + summary_byte_cnt (bit_cnt);
 }
 
 /* Destroys bitmap B, freeing its storage.
@@ -148,6 +251,7 @@ bitmap_mark (struct bitmap *b, size_t bit_idx) {
 	   is guaranteed to be atomic on a uniprocessor machine.  See
 	   the description of the OR instruction in [IA32-v2b]. */
 	asm ("lock orq %1, %0" : "=m" (b->bits[idx]) : "r" (mask) : "cc");
+	summary_update (b, idx);
 }
 
 /* Atomically sets the bit numbered BIT_IDX in B to false. */
@@ -160,6 +264,7 @@ bitmap_reset (struct bitmap *b, size_t bit_idx) {
 	   is guaranteed to be atomic on a uniprocessor machine.  See
 	   the description of the AND instruction in [IA32-v2a]. */
 	asm ("lock andq %1, %0" : "=m" (b->bits[idx]) : "r" (~mask) : "cc");
+	summary_update (b, idx);
 }
 
 /* Atomically toggles the bit numbered IDX in B;
@@ -174,6 +279,7 @@ bitmap_flip (struct bitmap *b, size_t bit_idx) {
 	   is guaranteed to be atomic on a uniprocessor machine.  See
 	   the description of the XOR instruction in [IA32-v2b]. */
 	asm ("lock xorq %1, %0" : "=m" (b->bits[idx]) : "r" (mask) : "cc");
+	summary_update (b, idx);
 }
 
 /* Returns the value of the bit numbered IDX in B. */
@@ -194,17 +300,27 @@ bitmap_set_all (struct bitmap *b, bool value) {
 	bitmap_set_multiple (b, 0, bitmap_size (b), value);
 }
 
-/* Sets the CNT bits starting at START in B to VALUE. */
+/* Sets the CNT bits starting at START in B to VALUE, an element
+   at a time. */
 void
 bitmap_set_multiple (struct bitmap *b, size_t start, size_t cnt, bool value) {
-	size_t i;
+	size_t elem;
 
 	ASSERT (b != NULL);
 	ASSERT (start <= b->bit_cnt);
 	ASSERT (start + cnt <= b->bit_cnt);
 
-	for (i = 0; i < cnt; i++)
-		bitmap_set (b, start + i, value);
+	if (cnt == 0)
+		return;
+	for (elem = elem_idx (start); elem <= elem_idx (start + cnt - 1); elem++) {
+		elem_type mask = range_mask (elem, start, start + cnt);
+
+		if (value)
+			asm ("lock orq %1, %0" : "=m" (b->bits[elem]) : "r" (mask) : "cc");
+		else
+			asm ("lock andq %1, %0" : "=m" (b->bits[elem]) : "r" (~mask) : "cc");
+		summary_update (b, elem);
+	}
 }
 
 /* Returns the number of bits in B between START and START + CNT,
@@ -218,9 +334,12 @@ bitmap_count (const struct bitmap *b, size_t start, size_t cnt, bool value) {
 	ASSERT (start + cnt <= b->bit_cnt);
 
 	value_cnt = 0;
-	for (i = 0; i < cnt; i++)
-		if (bitmap_test (b, start + i) == value)
-			value_cnt++;
+	if (cnt == 0)
+		return 0;
+	for (i = elem_idx (start); i <= elem_idx (start + cnt - 1); i++) {
+		elem_type bits = value ? b->bits[i] : ~b->bits[i];
+		value_cnt += elem_popcount (bits & range_mask (i, start, start + cnt));
+	}
 	return value_cnt;
 }
 
@@ -228,16 +347,11 @@ bitmap_count (const struct bitmap *b, size_t start, size_t cnt, bool value) {
    exclusive, are set to VALUE, and false otherwise. */
 bool
 bitmap_contains (const struct bitmap *b, size_t start, size_t cnt, bool value) {
-	size_t i;
-
 	ASSERT (b != NULL);
 	ASSERT (start <= b->bit_cnt);
 	ASSERT (start + cnt <= b->bit_cnt);
 
-	for (i = 0; i < cnt; i++)
-		if (bitmap_test (b, start + i) == value)
-			return true;
-	return false;
+	return find_next (b, start, start + cnt, value) < start + cnt;
 }
 
 /* Returns true if any bits in B between START and START + CNT,
@@ -274,10 +388,25 @@ bitmap_scan (const struct bitmap *b, size_t start, size_t cnt, bool value) {
 
 	if (cnt <= b->bit_cnt) {
 		size_t last = b->bit_cnt - cnt;
-		size_t i;
-		for (i = start; i <= last; i++)
-			if (!bitmap_contains (b, i, cnt, !value))
+		size_t i = start;
+
+		if (cnt == 0)
+			return start <= last ? start : BITMAP_ERROR;
+
+		/* Find the next bit set to VALUE, then see how far the
+		   run starting there goes.  A run cut short resumes the
+		   search past the bit that cut it. */
+		while (i <= last) {
+			size_t end;
+
+			i = find_next (b, i, last + 1, value);
+			if (i > last)
+				break;
+			end = find_next (b, i, i + cnt, !value);
+			if (end == i + cnt)
 				return i;
+			i = end + 1;
+		}
 	}
 	return BITMAP_ERROR;
 }
@@ -313,8 +442,12 @@ bitmap_read (struct bitmap *b, struct file *file) {
 	bool success = true;
 	if (b->bit_cnt > 0) {
 		off_t size = byte_cnt (b->bit_cnt);
+		size_t i;
+
 		success = file_read_at (file, b->bits, size, 0) == size;
 		b->bits[elem_cnt (b->bit_cnt) - 1] &= last_mask (b);
+		for (i = 0; i < elem_cnt (b->bit_cnt); i++)
+			summary_update (b, i);
 	}
 	return success;
 }
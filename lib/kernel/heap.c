@@ -0,0 +1,205 @@
+/* Pairing heap.
+
+   See heap.h for basic information.  The implementation follows
+   Fredman, Sedgewick, Sleator and Tarjan, "The Pairing Heap: A
+   New Form of Self-Adjusting Heap", with the two-pass merge done
+   iteratively so that the kernel stack use stays constant. */
+
+#include "heap.h"
+#include "../debug.h"
+
+static struct heap_elem *meld (struct heap *,
+		struct heap_elem *, struct heap_elem *);
+static struct heap_elem *merge_pairs (struct heap *, struct heap_elem *);
+static void detach (struct heap_elem *);
+
+/* Initializes heap H as an empty heap ordered by LESS, given
+   auxiliary data AUX. */
+void
+heap_init (struct heap *h, heap_less_func *less, void *aux) {
+	ASSERT (h != NULL);
+	ASSERT (less != NULL);
+
+	h->root = NULL;
+	h->elem_cnt = 0;
+	h->less = less;
+	h->aux = aux;
+}
+
+/* Inserts NEW into heap H. */
+void
+heap_push (struct heap *h, struct heap_elem *new) {
+	ASSERT (h != NULL);
+	ASSERT (new != NULL);
+
+	new->child = new->next = new->prev = NULL;
+	h->root = meld (h, h->root, new);
+	h->elem_cnt++;
+}
+
+/* Removes the top element of heap H and returns it.
+   Undefined behavior if H is empty. */
+struct heap_elem *
+heap_pop (struct heap *h) {
+	struct heap_elem *top;
+
+	ASSERT (h != NULL);
+	ASSERT (h->root != NULL);
+
+	top = h->root;
+	h->root = merge_pairs (h, top->child);
+	h->elem_cnt--;
+	top->child = NULL;
+	return top;
+}
+
+/* Removes E, which must be an element of heap H. */
+void
+heap_remove (struct heap *h, struct heap_elem *e) {
+	ASSERT (h != NULL);
+	ASSERT (e != NULL);
+
+	if (e == h->root) {
+		heap_pop (h);
+		return;
+	}
+
+	detach (e);
+	h->root = meld (h, h->root, merge_pairs (h, e->child));
+	h->elem_cnt--;
+	e->child = NULL;
+}
+
+/* Restores heap order after the key of E, an element of heap H,
+   has changed in either direction. */
+void
+heap_update (struct heap *h, struct heap_elem *e) {
+	ASSERT (h != NULL);
+	ASSERT (e != NULL);
+
+	heap_remove (h, e);
+	heap_push (h, e);
+}
+
+/* Calls ACTION on each element of heap H, in no particular
+   order, passing AUX.  ACTION must not modify H. */
+void
+heap_apply (struct heap *h, heap_action_func *action, void *aux) {
+	struct heap_elem *e;
+
+	ASSERT (h != NULL);
+	ASSERT (action != NULL);
+
+	e = h->root;
+	while (e != NULL) {
+		action (e, aux);
+		if (e->child != NULL)
+			e = e->child;
+		else {
+			/* Climb until we find an unvisited sibling.  A node's
+			   parent is the `prev' of its leftmost sibling. */
+			while (e != NULL && e->next == NULL) {
+				while (e->prev != NULL && e->prev->child != e)
+					e = e->prev;
+				e = e->prev;
+			}
+			if (e != NULL)
+				e = e->next;
+		}
+	}
+}
+
+/* Returns the top element of heap H, or a null pointer if H is
+   empty. */
+struct heap_elem *
+heap_top (const struct heap *h) {
+	ASSERT (h != NULL);
+	return h->root;
+}
+
+/* Returns the number of elements in H. */
+size_t
+heap_size (const struct heap *h) {
+	ASSERT (h != NULL);
+	return h->elem_cnt;
+}
+
+/* Returns true if H contains no elements, false otherwise. */
+bool
+heap_empty (const struct heap *h) {
+	ASSERT (h != NULL);
+	return h->root == NULL;
+}
+
+/* Links heap roots A and B, either of which may be null, and
+   returns the root of the result.  The loser becomes the
+   leftmost child of the winner. */
+static struct heap_elem *
+meld (struct heap *h, struct heap_elem *a, struct heap_elem *b) {
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+
+	if (h->less (b, a, h->aux)) {
+		struct heap_elem *t = a;
+		a = b;
+		b = t;
+	}
+
+	b->prev = a;
+	b->next = a->child;
+	if (a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+	a->next = a->prev = NULL;
+	return a;
+}
+
+/* Combines the sibling list starting at FIRST into a single heap
+   and returns its root.  First pass: meld siblings pairwise from
+   left to right, stacking the results.  Second pass: meld the
+   stacked results from right to left. */
+static struct heap_elem *
+merge_pairs (struct heap *h, struct heap_elem *first) {
+	struct heap_elem *stack = NULL;
+	struct heap_elem *root = NULL;
+
+	while (first != NULL) {
+		struct heap_elem *a = first;
+		struct heap_elem *b = a->next;
+
+		first = b != NULL ? b->next : NULL;
+		a->next = a->prev = NULL;
+		if (b != NULL) {
+			b->next = b->prev = NULL;
+			a = meld (h, a, b);
+		}
+		a->next = stack;
+		stack = a;
+	}
+
+	while (stack != NULL) {
+		struct heap_elem *next = stack->next;
+
+		stack->next = NULL;
+		root = meld (h, root, stack);
+		stack = next;
+	}
+	return root;
+}
+
+/* Unlinks non-root E, along with its subtree, from its parent
+   and siblings. */
+static void
+detach (struct heap_elem *e) {
+	ASSERT (e->prev != NULL);
+
+	if (e->prev->child == e)
+		e->prev->child = e->next;
+	else
+		e->prev->next = e->next;
+	if (e->next != NULL)
+		e->next->prev = e->prev;
+	e->next = e->prev = NULL;
+}
@@ -0,0 +1,307 @@
+/* Red-black tree.
+
+   See rbtree.h for basic information.  The algorithms are those
+   of Cormen, Leiserson, Rivest and Stein, "Introduction to
+   Algorithms", chapter 13, with null pointers for leaves. */
+
+#include "rbtree.h"
+#include "../debug.h"
+
+static void rotate_left (struct rb_tree *, struct rb_node *);
+static void rotate_right (struct rb_tree *, struct rb_node *);
+static void replace_child (struct rb_tree *, struct rb_node *parent,
+		struct rb_node *old, struct rb_node *new);
+static void insert_fixup (struct rb_tree *, struct rb_node *);
+static void remove_fixup (struct rb_tree *, struct rb_node *,
+		struct rb_node *parent);
+
+static inline bool
+is_red (const struct rb_node *n) {
+	return n != NULL && n->red;
+}
+
+/* Initializes tree T as an empty tree ordered by LESS, given
+   auxiliary data AUX. */
+void
+rb_init (struct rb_tree *t, rb_less_func *less, void *aux) {
+	ASSERT (t != NULL);
+	ASSERT (less != NULL);
+
+	t->root = t->first = NULL;
+	t->node_cnt = 0;
+	t->less = less;
+	t->aux = aux;
+}
+
+/* Inserts NEW into tree T, after any nodes that compare equal
+   to it. */
+void
+rb_insert (struct rb_tree *t, struct rb_node *new) {
+	struct rb_node *parent = NULL;
+	struct rb_node **link = &t->root;
+	bool leftmost = true;
+
+	ASSERT (t != NULL);
+	ASSERT (new != NULL);
+
+	while (*link != NULL) {
+		parent = *link;
+		if (t->less (new, parent, t->aux))
+			link = &parent->left;
+		else {
+			link = &parent->right;
+			leftmost = false;
+		}
+	}
+
+	new->parent = parent;
+	new->left = new->right = NULL;
+	new->red = true;
+	*link = new;
+	if (leftmost)
+		t->first = new;
+	t->node_cnt++;
+
+	insert_fixup (t, new);
+}
+
+/* Removes node Z, which must be in tree T. */
+void
+rb_remove (struct rb_tree *t, struct rb_node *z) {
+	struct rb_node *y, *x, *x_parent;
+	bool y_red;
+
+	ASSERT (t != NULL);
+	ASSERT (z != NULL);
+
+	if (t->first == z)
+		t->first = rb_next (z);
+
+	/* Y is the node actually unlinked from the tree: Z itself if
+	   it has at most one child, otherwise its successor, which
+	   then takes Z's place. */
+	if (z->left == NULL || z->right == NULL)
+		y = z;
+	else
+		for (y = z->right; y->left != NULL; y = y->left)
+			continue;
+
+	x = y->left != NULL ? y->left : y->right;
+	x_parent = y->parent;
+	if (x != NULL)
+		x->parent = x_parent;
+	replace_child (t, y->parent, y, x);
+	y_red = y->red;
+
+	if (y != z) {
+		if (x_parent == z)
+			x_parent = y;
+		y->parent = z->parent;
+		y->left = z->left;
+		y->right = z->right;
+		y->red = z->red;
+		if (y->left != NULL)
+			y->left->parent = y;
+		if (y->right != NULL)
+			y->right->parent = y;
+		replace_child (t, z->parent, z, y);
+	}
+
+	if (!y_red)
+		remove_fixup (t, x, x_parent);
+	t->node_cnt--;
+}
+
+/* Returns the least node in tree T, or a null pointer if T is
+   empty. */
+struct rb_node *
+rb_first (const struct rb_tree *t) {
+	ASSERT (t != NULL);
+	return t->first;
+}
+
+/* Returns the node that follows N in order, or a null pointer if
+   N is the greatest node in its tree. */
+struct rb_node *
+rb_next (const struct rb_node *n) {
+	ASSERT (n != NULL);
+
+	if (n->right != NULL) {
+		n = n->right;
+		while (n->left != NULL)
+			n = n->left;
+		return (struct rb_node *) n;
+	}
+	while (n->parent != NULL && n == n->parent->right)
+		n = n->parent;
+	return n->parent;
+}
+
+/* Returns the number of nodes in T. */
+size_t
+rb_size (const struct rb_tree *t) {
+	ASSERT (t != NULL);
+	return t->node_cnt;
+}
+
+/* Returns true if T contains no nodes, false otherwise. */
+bool
+rb_empty (const struct rb_tree *t) {
+	ASSERT (t != NULL);
+	return t->root == NULL;
+}
+
+/* Makes NEW, which may be null, take the place of OLD as a child
+   of PARENT, or as the root of T if PARENT is null. */
+static void
+replace_child (struct rb_tree *t, struct rb_node *parent,
+		struct rb_node *old, struct rb_node *new) {
+	if (parent == NULL)
+		t->root = new;
+	else if (parent->left == old)
+		parent->left = new;
+	else
+		parent->right = new;
+}
+
+/* Rotates the subtree rooted at X to the left, so that X's right
+   child takes its place. */
+static void
+rotate_left (struct rb_tree *t, struct rb_node *x) {
+	struct rb_node *y = x->right;
+
+	x->right = y->left;
+	if (y->left != NULL)
+		y->left->parent = x;
+	y->parent = x->parent;
+	replace_child (t, x->parent, x, y);
+	y->left = x;
+	x->parent = y;
+}
+
+/* Rotates the subtree rooted at X to the right, so that X's left
+   child takes its place. */
+static void
+rotate_right (struct rb_tree *t, struct rb_node *x) {
+	struct rb_node *y = x->left;
+
+	x->left = y->right;
+	if (y->right != NULL)
+		y->right->parent = x;
+	y->parent = x->parent;
+	replace_child (t, x->parent, x, y);
+	y->right = x;
+	x->parent = y;
+}
+
+/* Restores the red-black properties after red node N has been
+   inserted. */
+static void
+insert_fixup (struct rb_tree *t, struct rb_node *n) {
+	struct rb_node *p;
+
+	while ((p = n->parent) != NULL && p->red) {
+		struct rb_node *g = p->parent;
+
+		if (p == g->left) {
+			struct rb_node *u = g->right;
+
+			if (is_red (u)) {
+				p->red = u->red = false;
+				g->red = true;
+				n = g;
+				continue;
+			}
+			if (n == p->right) {
+				rotate_left (t, p);
+				n = p;
+				p = n->parent;
+			}
+			p->red = false;
+			g->red = true;
+			rotate_right (t, g);
+		} else {
+			struct rb_node *u = g->left;
+
+			if (is_red (u)) {
+				p->red = u->red = false;
+				g->red = true;
+				n = g;
+				continue;
+			}
+			if (n == p->left) {
+				rotate_right (t, p);
+				n = p;
+				p = n->parent;
+			}
+			p->red = false;
+			g->red = true;
+			rotate_left (t, g);
+		}
+	}
+	t->root->red = false;
+}
+
+/* Restores the red-black properties after a black node has been
+   unlinked.  X, which may be null, is the node that took its
+   place, and PARENT is X's parent. */
+static void
+remove_fixup (struct rb_tree *t, struct rb_node *x, struct rb_node *parent) {
+	while (x != t->root && !is_red (x)) {
+		if (x == parent->left) {
+			struct rb_node *w = parent->right;
+
+			if (w->red) {
+				w->red = false;
+				parent->red = true;
+				rotate_left (t, parent);
+				w = parent->right;
+			}
+			if (!is_red (w->left) && !is_red (w->right)) {
+				w->red = true;
+				x = parent;
+				parent = x->parent;
+			} else {
+				if (!is_red (w->right)) {
+					w->left->red = false;
+					w->red = true;
+					rotate_right (t, w);
+					w = parent->right;
+				}
+				w->red = parent->red;
+				parent->red = false;
+				w->right->red = false;
+				rotate_left (t, parent);
+				x = t->root;
+			}
+		} else {
+			struct rb_node *w = parent->left;
+
+			if (w->red) {
+				w->red = false;
+				parent->red = true;
+				rotate_right (t, parent);
+				w = parent->left;
+			}
+			if (!is_red (w->left) && !is_red (w->right)) {
+				w->red = true;
+				x = parent;
+				parent = x->parent;
+			} else {
+				if (!is_red (w->left)) {
+					w->right->red = false;
+					w->red = true;
+					rotate_left (t, w);
+					w = parent->left;
+				}
+				w->red = parent->red;
+				parent->red = false;
+				w->left->red = false;
+				rotate_right (t, parent);
+				x = t->root;
+			}
+		}
+	}
+	if (x != NULL)
+		x->red = false;
+}
@@ -194,3 +194,57 @@ int
 umount (const char *path) {
 	return syscall1 (SYS_UMOUNT, path);
 }
+
+bool
+set_deadline (unsigned runtime, unsigned period) {
+	return syscall2 (SYS_SET_DEADLINE, runtime, period);
+}
+
+int
+cpu_group_create (unsigned quota, unsigned period) {
+	return syscall2 (SYS_CPU_GROUP_CREATE, quota, period);
+}
+
+bool
+cpu_group_join (int group) {
+	return syscall1 (SYS_CPU_GROUP_JOIN, group);
+}
+
+bool
+cpu_group_usage (int group, long long *consumed, long long *throttled) {
+	return syscall3 (SYS_CPU_GROUP_USAGE, group, consumed, throttled);
+}
+
+int
+getrusage (int who, struct rusage *usage) {
+	return syscall2 (SYS_GETRUSAGE, who, usage);
+}
+
+int
+futex_wait (int *addr, int expected, int timeout) {
+	return syscall3 (SYS_FUTEX_WAIT, addr, expected, timeout);
+}
+
+int
+futex_wake (int *addr, int n) {
+	return syscall2 (SYS_FUTEX_WAKE, addr, n);
+}
+
+/* Starts FN(ARG) as a new thread of this process, running on the
+   stack whose top is STACK.  FN must not return: it ends with
+   exit_thread() or exit(). */
+tid_t
+clone (void (*fn) (void *), void *arg, void *stack) {
+	return syscall3 (SYS_CLONE, fn, arg, stack);
+}
+
+int
+join (tid_t tid) {
+	return syscall1 (SYS_JOIN, tid);
+}
+
+void
+exit_thread (int status) {
+	syscall1 (SYS_EXIT_THREAD, status);
+	NOT_REACHED ();
+}
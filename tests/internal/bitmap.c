@@ -0,0 +1,181 @@
+/* Test program and microbenchmark for lib/kernel/bitmap.c.
+
+   Checks the element-at-a-time search and the summary level
+   against a plain array of bools, then times bitmap_scan() on a
+   nearly full bitmap the size of a large page pool against a
+   search that tests one bit at a time, as bitmap_scan() used
+   to.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <bitmap.h>
+#include <debug.h>
+#include <random.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/test.h"
+
+/* Maximum number of bits in a bitmap that we will test. */
+#define MAX_BITS 700
+
+/* Bits in the benchmark bitmap: 4 GB worth of pages. */
+#define BENCH_BITS (1 << 20)
+
+/* Number of searches timed in the benchmark. */
+#define BENCH_SCANS 200
+
+static size_t ref_scan (const bool[], size_t bit_cnt, size_t start,
+                        size_t cnt, bool value);
+static size_t bit_scan (const struct bitmap *, size_t start, size_t cnt,
+                        bool value);
+static void benchmark (void);
+
+/* Test the bitmap implementation. */
+void
+test (void)
+{
+  size_t bit_cnt;
+
+  printf ("testing various size bitmaps:");
+  for (bit_cnt = 0; bit_cnt < MAX_BITS; bit_cnt = bit_cnt * 4 / 3 + 1)
+    {
+      static bool ref[MAX_BITS];
+      struct bitmap *b;
+      int op;
+
+      printf (" %zu", bit_cnt);
+      b = bitmap_create (bit_cnt);
+      ASSERT (b != NULL);
+      memset (ref, 0, sizeof ref);
+      for (op = 0; op < 2000; op++)
+        {
+          size_t start = random_ulong () % (bit_cnt + 1);
+          size_t cnt = random_ulong () % (bit_cnt - start + 1);
+          bool value = random_ulong () % 3 != 0;
+          size_t i, value_cnt;
+
+          switch (random_ulong () % 4)
+            {
+            case 0:
+              /* Set a run, crossing element boundaries. */
+              bitmap_set_multiple (b, start, cnt, value);
+              for (i = 0; i < cnt; i++)
+                ref[start + i] = value;
+              break;
+
+            case 1:
+              /* Flip a single bit. */
+              if (start < bit_cnt)
+                {
+                  bitmap_flip (b, start);
+                  ref[start] = !ref[start];
+                }
+              break;
+
+            case 2:
+              /* Search for a run. */
+              cnt = random_ulong () % 70;
+              ASSERT (bitmap_scan (b, start, cnt, value)
+                      == ref_scan (ref, bit_cnt, start, cnt, value));
+              break;
+
+            case 3:
+              /* Count and test a range. */
+              for (i = value_cnt = 0; i < cnt; i++)
+                value_cnt += ref[start + i] == value;
+              ASSERT (bitmap_count (b, start, cnt, value) == value_cnt);
+              ASSERT (bitmap_contains (b, start, cnt, value)
+                      == (value_cnt > 0));
+              break;
+            }
+          for (i = 0; i < bit_cnt; i++)
+            ASSERT (bitmap_test (b, i) == ref[i]);
+        }
+      bitmap_destroy (b);
+    }
+  printf (" done\n");
+
+  benchmark ();
+  printf ("bitmap: PASS\n");
+}
+
+/* Times searches for a free bit and for a free run of 16 bits
+   in a bitmap that is full except near its end, once with
+   bitmap_scan() and once one bit at a time. */
+static void
+benchmark (void)
+{
+  static const size_t cnts[] = {1, 16};
+  struct bitmap *b = bitmap_create (BENCH_BITS);
+  size_t i, j;
+
+  ASSERT (b != NULL);
+  bitmap_set_all (b, true);
+  for (i = BENCH_BITS - 4096; i < BENCH_BITS; i += 97)
+    bitmap_reset (b, i);
+  bitmap_set_multiple (b, BENCH_BITS - 64, 32, false);
+
+  for (i = 0; i < sizeof cnts / sizeof *cnts; i++)
+    {
+      size_t expected = bit_scan (b, 0, cnts[i], false);
+      int64_t start;
+      int64_t fast, slow;
+
+      start = timer_ticks ();
+      for (j = 0; j < BENCH_SCANS; j++)
+        ASSERT (bitmap_scan (b, 0, cnts[i], false) == expected);
+      fast = timer_elapsed (start);
+
+      start = timer_ticks ();
+      for (j = 0; j < BENCH_SCANS / 10; j++)
+        ASSERT (bit_scan (b, 0, cnts[i], false) == expected);
+      slow = timer_elapsed (start) * 10;
+
+      printf ("%d scans for %zu free bits in %d bits: "
+              "%"PRId64" ticks, bit at a time %"PRId64" ticks\n",
+              BENCH_SCANS, cnts[i], BENCH_BITS, fast, slow);
+    }
+  bitmap_destroy (b);
+}
+
+/* Returns the index of the first run of CNT bits set to VALUE at
+   or after START among the BIT_CNT bools in REF, or
+   BITMAP_ERROR. */
+static size_t
+ref_scan (const bool ref[], size_t bit_cnt, size_t start, size_t cnt,
+          bool value)
+{
+  size_t i, j;
+
+  for (i = start; i + cnt <= bit_cnt; i++)
+    {
+      for (j = 0; j < cnt; j++)
+        if (ref[i + j] != value)
+          break;
+      if (j == cnt)
+        return i;
+    }
+  return BITMAP_ERROR;
+}
+
+/* Searches B like bitmap_scan(), but testing one bit at a time
+   from every candidate start. */
+static size_t
+bit_scan (const struct bitmap *b, size_t start, size_t cnt, bool value)
+{
+  size_t i, j;
+
+  for (i = start; i + cnt <= bitmap_size (b); i++)
+    {
+      for (j = 0; j < cnt; j++)
+        if (bitmap_test (b, i + j) != value)
+          break;
+      if (j == cnt)
+        return i;
+    }
+  return BITMAP_ERROR;
+}
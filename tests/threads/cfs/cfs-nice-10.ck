@@ -0,0 +1,7 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+use tests::threads::cfs;
+
+check_cfs_fair ([0, 1, 2, 3, 4, 5, 6, 7, 8, 9], 25);
@@ -0,0 +1,88 @@
+/* Checks that a CPU bandwidth group is held to its quota.
+
+   Group G may use 2 ticks in every 10, and group H, nested in
+   G, may use 8.  A spinning thread in H competes for
+   TEST_TICKS ticks with a spinning thread in the root group.
+   H's thread must be held to G's quota, so G has to be
+   throttled while H never uses up its own. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define TEST_TICKS 100
+#define QUOTA 2
+#define PERIOD 10
+
+static thread_func capped_thread, free_thread;
+static struct semaphore done;
+static volatile bool stop;
+
+void
+test_cpugroup_quota (void) 
+{
+  long long g_consumed, g_throttled, h_consumed, h_throttled;
+  int g, h;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&done, 0);
+  stop = false;
+
+  g = thread_group_create (thread_group_current (), QUOTA, PERIOD);
+  h = thread_group_create (g, 8, PERIOD);
+  if (g < 0 || h < 0)
+    fail ("could not create groups");
+
+  thread_create ("capped", PRI_DEFAULT, capped_thread, &h);
+  thread_create ("free", PRI_DEFAULT, free_thread, NULL);
+  timer_sleep (TEST_TICKS);
+
+  if (!thread_group_usage (g, &g_consumed, &g_throttled)
+      || !thread_group_usage (h, &h_consumed, &h_throttled))
+    fail ("groups disappeared");
+  stop = true;
+  sema_down (&done);
+  sema_down (&done);
+
+  if (g_consumed > (TEST_TICKS / PERIOD + 1) * QUOTA)
+    fail ("group used %lld ticks in %d, quota is %d per %d",
+          g_consumed, TEST_TICKS, QUOTA, PERIOD);
+  msg ("Group stayed within its quota.");
+  if (g_consumed < TEST_TICKS / PERIOD)
+    fail ("group used only %lld ticks in %d", g_consumed, TEST_TICKS);
+  msg ("Group got CPU time.");
+  if (h_consumed != g_consumed)
+    fail ("nested group used %lld ticks, parent %lld",
+          h_consumed, g_consumed);
+  if (h_throttled != 0)
+    fail ("nested group was throttled for %lld ticks", h_throttled);
+  msg ("Nested group was held to its parent's quota.");
+  if (g_throttled == 0)
+    fail ("group was never throttled");
+  msg ("Group was throttled.");
+}
+
+static void
+capped_thread (void *group_) 
+{
+  int *group = group_;
+
+  if (!thread_group_join (*group))
+    fail ("could not join group");
+  while (!stop)
+    continue;
+  sema_up (&done);
+}
+
+static void
+free_thread (void *aux UNUSED) 
+{
+  while (!stop)
+    continue;
+  sema_up (&done);
+}
@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(cpugroup-quota) begin
+(cpugroup-quota) Group stayed within its quota.
+(cpugroup-quota) Group got CPU time.
+(cpugroup-quota) Nested group was held to its parent's quota.
+(cpugroup-quota) Group was throttled.
+(cpugroup-quota) end
+EOF
+pass;
@@ -0,0 +1,52 @@
+/* Checks admission control for the EDF class: invalid
+   parameters are refused, and a thread is admitted only if the
+   total EDF utilization stays within the limit, which is 90%.
+   A thread that exits gives its utilization back. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+static thread_func second_thread;
+static struct semaphore done;
+
+static void
+try_deadline (int64_t runtime, int64_t period) 
+{
+  msg ("%s %lld/%lld: %s", thread_name (), (long long) runtime,
+       (long long) period,
+       thread_set_deadline (runtime, period) ? "admitted" : "refused");
+}
+
+void
+test_edf_admission (void) 
+{
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&done, 0);
+
+  try_deadline (0, 10);
+  try_deadline (11, 10);
+  try_deadline (-1, 10);
+  try_deadline (5, 10);
+
+  thread_create ("second", PRI_DEFAULT, second_thread, NULL);
+  sema_down (&done);
+
+  try_deadline (0, 0);
+  try_deadline (9, 10);
+  try_deadline (10, 10);
+  try_deadline (0, 0);
+}
+
+static void
+second_thread (void *aux UNUSED) 
+{
+  try_deadline (5, 10);
+  try_deadline (4, 10);
+  try_deadline (2, 5);
+  sema_up (&done);
+}
@@ -0,0 +1,20 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(edf-admission) begin
+(edf-admission) main 0/10: refused
+(edf-admission) main 11/10: refused
+(edf-admission) main -1/10: refused
+(edf-admission) main 5/10: admitted
+(edf-admission) second 5/10: refused
+(edf-admission) second 4/10: admitted
+(edf-admission) second 2/5: admitted
+(edf-admission) main 0/0: admitted
+(edf-admission) main 9/10: admitted
+(edf-admission) main 10/10: refused
+(edf-admission) main 0/0: admitted
+(edf-admission) end
+EOF
+pass;
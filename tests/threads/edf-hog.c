@@ -0,0 +1,78 @@
+/* Checks that an EDF thread meets its deadlines while a CPU hog
+   of the highest priority competes for the processor.
+
+   The EDF thread asks for 3 ticks every 10 and does 2 ticks of
+   work per period, for EDF_PERIODS periods.  The hog spins at
+   PRI_MAX for longer than that.  Without the EDF class the
+   worker, at PRI_MIN, would not run at all until the hog was
+   done, and would miss every deadline. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define EDF_RUNTIME 3
+#define EDF_PERIOD 10
+#define EDF_WORK 2
+#define EDF_PERIODS 30
+
+static thread_func edf_thread, hog_thread;
+static struct semaphore started, finished;
+static int missed, kernel_missed;
+
+void
+test_edf_hog (void) 
+{
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&started, 0);
+  sema_init (&finished, 0);
+
+  /* The EDF thread starts at the lowest priority and stays
+     there: only its deadline lets it past the hog. */
+  thread_create ("edf", PRI_MIN, edf_thread, NULL);
+  sema_down (&started);
+  thread_create ("hog", PRI_MAX, hog_thread, NULL);
+
+  sema_down (&finished);
+  sema_down (&finished);
+
+  msg ("EDF thread missed %d of %d deadlines.", missed, EDF_PERIODS);
+  msg ("Kernel counted %d missed deadlines.", kernel_missed);
+}
+
+static void
+edf_thread (void *aux UNUSED) 
+{
+  int i;
+
+  if (!thread_set_deadline (EDF_RUNTIME, EDF_PERIOD))
+    fail ("EDF thread was not admitted");
+  sema_up (&started);
+
+  for (i = 0; i < EDF_PERIODS; i++) 
+    {
+      int64_t start = timer_ticks ();
+
+      while (timer_elapsed (start) < EDF_WORK)
+        continue;
+      if (!thread_edf_next_period ())
+        missed++;
+    }
+  kernel_missed = thread_get_deadline_misses ();
+  sema_up (&finished);
+}
+
+static void
+hog_thread (void *aux UNUSED) 
+{
+  int64_t start = timer_ticks ();
+
+  while (timer_elapsed (start) < (EDF_PERIODS + 5) * EDF_PERIOD)
+    continue;
+  sema_up (&finished);
+}
@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(edf-hog) begin
+(edf-hog) EDF thread missed 0 of 30 deadlines.
+(edf-hog) Kernel counted 0 missed deadlines.
+(edf-hog) end
+EOF
+pass;
@@ -0,0 +1,108 @@
+/* Checks that recent_cpu decay reaches every thread even when
+   there are more threads than one second of decay batches can
+   cover.
+
+   The main thread first creates PAD_CNT threads that block on a
+   semaphore, so that all_list is longer than the scheduler can
+   walk in one second.  It then creates a "spin" thread, which
+   lands at the tail of all_list.  The spin thread raises its own
+   recent_cpu until its priority is well below PRI_DEFAULT, then
+   blocks.  A blocked thread's priority changes only through the
+   periodic decay, so if that decay reaches the tail of all_list,
+   the spin thread's priority climbs back above PRI_DEFAULT while
+   it sleeps. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+/* More than the 8 threads per tick, 100 ticks per second, that
+   the scheduler decays. */
+#define PAD_CNT 1000
+
+struct decay_info
+  {
+    struct semaphore pad_sema;  /* Pad threads block here. */
+    struct semaphore spun;      /* Upped once "spin" is about to block. */
+    struct semaphore release;   /* "spin" blocks here. */
+    struct thread *spin;        /* The "spin" thread. */
+  };
+
+static thread_func pad_thread;
+static thread_func spin_thread;
+
+void
+test_mlfqs_decay_many (void)
+{
+  struct decay_info info;
+  enum intr_level old_level;
+  int priority;
+  int i;
+
+  ASSERT (thread_mlfqs);
+
+  sema_init (&info.pad_sema, 0);
+  sema_init (&info.spun, 0);
+  sema_init (&info.release, 0);
+
+  msg ("Creating %d blocked threads...", PAD_CNT);
+  for (i = 0; i < PAD_CNT; i++)
+    {
+      char name[16];
+      snprintf (name, sizeof name, "pad %d", i);
+      if (thread_create (name, PRI_DEFAULT, pad_thread, &info) == TID_ERROR)
+        fail ("creating thread %d failed", i);
+    }
+
+  msg ("Creating spin thread...");
+  thread_create ("spin", PRI_DEFAULT, spin_thread, &info);
+  sema_down (&info.spun);
+
+  msg ("Main thread sleeping 5 seconds...");
+  timer_sleep (5 * TIMER_FREQ);
+
+  old_level = intr_disable ();
+  priority = info.spin->priority;
+  intr_set_level (old_level);
+  if (priority <= PRI_DEFAULT)
+    fail ("spin thread still at priority %d after 5 seconds blocked",
+          priority);
+  msg ("Spin thread's priority rose while it was blocked.");
+
+  sema_up (&info.release);
+  for (i = 0; i < PAD_CNT; i++)
+    sema_up (&info.pad_sema);
+  timer_sleep (TIMER_FREQ);
+}
+
+static void
+pad_thread (void *info_)
+{
+  struct decay_info *info = info_;
+
+  sema_down (&info->pad_sema);
+}
+
+static void
+spin_thread (void *info_)
+{
+  struct decay_info *info = info_;
+  int64_t start_time;
+
+  info->spin = thread_current ();
+  thread_set_nice (10);
+
+  msg ("Spin thread spinning until its priority drops...");
+  start_time = timer_ticks ();
+  while (thread_get_priority () > PRI_DEFAULT - 10)
+    if (timer_elapsed (start_time) > 10 * TIMER_FREQ)
+      fail ("spin thread priority stuck at %d", thread_get_priority ());
+
+  msg ("Spin thread blocking...");
+  sema_up (&info->spun);
+  sema_down (&info->release);
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(mlfqs-decay-many) begin
+(mlfqs-decay-many) Creating 1000 blocked threads...
+(mlfqs-decay-many) Creating spin thread...
+(mlfqs-decay-many) Spin thread spinning until its priority drops...
+(mlfqs-decay-many) Spin thread blocking...
+(mlfqs-decay-many) Main thread sleeping 5 seconds...
+(mlfqs-decay-many) Spin thread's priority rose while it was blocked.
+(mlfqs-decay-many) end
+EOF
+pass;
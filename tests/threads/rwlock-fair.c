@@ -0,0 +1,52 @@
+/* Checks that readers share a reader-writer lock, and that a
+   waiting writer is not starved by readers that arrive after
+   it.
+
+   The main thread reads.  A first reader joins it at once.  A
+   writer then has to wait, and a second reader, arriving after
+   the writer, has to wait behind it even though only readers
+   hold the lock. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+static thread_func reader_thread, writer_thread;
+static struct rwlock rwlock;
+
+void
+test_rwlock_fair (void) 
+{
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  rwlock_init (&rwlock);
+  rwlock_acquire_read (&rwlock);
+  thread_create ("reader 1", PRI_DEFAULT + 1, reader_thread, NULL);
+  thread_create ("writer", PRI_DEFAULT + 1, writer_thread, NULL);
+  thread_create ("reader 2", PRI_DEFAULT + 1, reader_thread, NULL);
+  msg ("Main thread releases the lock.");
+  rwlock_release_read (&rwlock);
+  msg ("Main thread finished.");
+}
+
+static void
+reader_thread (void *aux UNUSED) 
+{
+  msg ("Thread %s wants to read.", thread_name ());
+  rwlock_acquire_read (&rwlock);
+  msg ("Thread %s reads.", thread_name ());
+  rwlock_release_read (&rwlock);
+}
+
+static void
+writer_thread (void *aux UNUSED) 
+{
+  msg ("Thread %s wants to write.", thread_name ());
+  rwlock_acquire_write (&rwlock);
+  msg ("Thread %s writes.", thread_name ());
+  rwlock_release_write (&rwlock);
+  msg ("Thread %s finished.", thread_name ());
+}
@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(rwlock-fair) begin
+(rwlock-fair) Thread reader 1 wants to read.
+(rwlock-fair) Thread reader 1 reads.
+(rwlock-fair) Thread writer wants to write.
+(rwlock-fair) Thread reader 2 wants to read.
+(rwlock-fair) Main thread releases the lock.
+(rwlock-fair) Thread writer writes.
+(rwlock-fair) Thread writer finished.
+(rwlock-fair) Thread reader 2 reads.
+(rwlock-fair) Main thread finished.
+(rwlock-fair) end
+EOF
+pass;
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(rwlock-priority) begin
+(rwlock-priority) Thread writer wants to write.
+(rwlock-priority) Thread reader wants to read.
+(rwlock-priority) Main thread releases the lock.
+(rwlock-priority) Thread writer writes.
+(rwlock-priority) Thread reader reads.
+(rwlock-priority) Thread writer finished.
+(rwlock-priority) Main thread finished.
+(rwlock-priority) end
+EOF
+pass;
@@ -0,0 +1,66 @@
+/* Measures the cost of a thread switch.  The main thread and a
+   partner thread of equal priority hand a pair of semaphores
+   back and forth for one second, so that every handoff blocks
+   one thread and switches to the other.  Prints the number of
+   switches per second.
+
+   The rate depends on the host and the simulator, so the
+   checker only verifies that switching made progress.  In
+   particular, passing says nothing about whether one way of
+   switching threads is faster than another; compare the printed
+   rates by hand, on the same host, for that. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+static thread_func pong_thread;
+static struct semaphore ping, pong, finished;
+static volatile bool done;
+
+void
+test_switch_pingpong (void) 
+{
+  int64_t start, elapsed;
+  long long rounds = 0;
+
+  sema_init (&ping, 0);
+  sema_init (&pong, 0);
+  sema_init (&finished, 0);
+  done = false;
+  thread_create ("pong", thread_get_priority (), pong_thread, NULL);
+
+  /* Start on a fresh tick so the measurement window is exact. */
+  timer_sleep (1);
+  start = timer_ticks ();
+  while ((elapsed = timer_elapsed (start)) < TIMER_FREQ) 
+    {
+      sema_up (&ping);
+      sema_down (&pong);
+      rounds++;
+    }
+
+  done = true;
+  sema_up (&ping);
+  sema_down (&finished);
+
+  /* Each round switches to the partner and back. */
+  msg ("%lld switches in %lld ticks.", rounds * 2, (long long) elapsed);
+  msg ("%lld switches per second.", rounds * 2 * TIMER_FREQ / elapsed);
+}
+
+static void
+pong_thread (void *aux UNUSED) 
+{
+  for (;;) 
+    {
+      sema_down (&ping);
+      if (done)
+        break;
+      sema_up (&pong);
+    }
+  sema_up (&finished);
+}
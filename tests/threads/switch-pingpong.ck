@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+# The rate itself depends on the host, so only check that
+# the threads actually switched.  No speed is verified.
+my ($rate);
+foreach (@output) {
+    ($rate) = /^\(switch-pingpong\) (\d+) switches per second\.$/ and last;
+}
+fail "Switch rate missing from output.\n" if !defined $rate;
+fail "Threads never switched.\n" if $rate == 0;
+pass;
@@ -29,6 +29,12 @@ static const struct test tests[] =
     {"priority-preempt", test_priority_preempt},
     {"priority-sema", test_priority_sema},
     {"priority-condvar", test_priority_condvar},
+    {"switch-pingpong", test_switch_pingpong},
+    {"edf-admission", test_edf_admission},
+    {"edf-hog", test_edf_hog},
+    {"cpugroup-quota", test_cpugroup_quota},
+    {"rwlock-fair", test_rwlock_fair},
+    {"rwlock-priority", test_rwlock_priority},
     {"mlfqs-load-1", test_mlfqs_load_1},
     {"mlfqs-load-60", test_mlfqs_load_60},
     {"mlfqs-load-avg", test_mlfqs_load_avg},
@@ -38,6 +44,10 @@ static const struct test tests[] =
     {"mlfqs-nice-2", test_mlfqs_nice_2},
     {"mlfqs-nice-10", test_mlfqs_nice_10},
     {"mlfqs-block", test_mlfqs_block},
+    {"mlfqs-decay-many", test_mlfqs_decay_many},
+    {"cfs-fair-2", test_cfs_fair_2},
+    {"cfs-nice-2", test_cfs_nice_2},
+    {"cfs-nice-10", test_cfs_nice_10},
   };
 
 static const char *test_name;
@@ -23,6 +23,12 @@ extern test_func test_priority_fifo;
 extern test_func test_priority_preempt;
 extern test_func test_priority_sema;
 extern test_func test_priority_condvar;
+extern test_func test_switch_pingpong;
+extern test_func test_edf_admission;
+extern test_func test_edf_hog;
+extern test_func test_cpugroup_quota;
+extern test_func test_rwlock_fair;
+extern test_func test_rwlock_priority;
 extern test_func test_mlfqs_load_1;
 extern test_func test_mlfqs_load_60;
 extern test_func test_mlfqs_load_avg;
@@ -32,6 +38,10 @@ extern test_func test_mlfqs_fair_20;
 extern test_func test_mlfqs_nice_2;
 extern test_func test_mlfqs_nice_10;
 extern test_func test_mlfqs_block;
+extern test_func test_mlfqs_decay_many;
+extern test_func test_cfs_fair_2;
+extern test_func test_cfs_nice_2;
+extern test_func test_cfs_nice_10;
 
 void msg (const char *, ...);
 void fail (const char *, ...);
@@ -0,0 +1,24 @@
+/* A thread started with clone calls exit() while the main
+   thread sleeps on a futex that nobody wakes.  The whole process
+   must end with the thread's exit status. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static char stack[4096] __attribute__ ((aligned (16)));
+static int never;
+
+static void
+worker (void *aux UNUSED) 
+{
+  exit (57);
+}
+
+void
+test_main (void) 
+{
+  CHECK (clone (worker, NULL, stack + sizeof stack) != TID_ERROR, "clone");
+  futex_wait (&never, 0, 0);
+  fail ("main thread outlived exit()");
+}
@@ -0,0 +1,10 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(clone-exit) begin
+(clone-exit) clone
+clone-exit: exit(57)
+EOF
+pass;
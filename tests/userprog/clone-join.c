@@ -0,0 +1,53 @@
+/* Starts two threads in this process with clone and joins them.
+   Checks that they see our memory and our open files, that a
+   futex wakes a thread sleeping in another, and that a thread
+   cannot be joined twice. */
+
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static char stacks[2][4096] __attribute__ ((aligned (16)));
+static int slots[2];
+static int ready;
+static int fd;
+static char first;
+
+static void
+worker (void *aux) 
+{
+  int i = (int) (long) aux;
+
+  slots[i] = i + 1;
+  if (i == 1)
+    {
+      /* Sleep until the main thread raises READY, then read
+         from the file it opened. */
+      while (ready == 0)
+        futex_wait (&ready, 0, 0);
+      if (read (fd, &first, 1) != 1)
+        exit_thread (-1);
+    }
+  exit_thread (10 + i);
+}
+
+void
+test_main (void) 
+{
+  tid_t t0, t1;
+
+  CHECK ((fd = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  CHECK ((t0 = clone (worker, (void *) 0, stacks[0] + sizeof stacks[0]))
+         != TID_ERROR, "clone thread 0");
+  CHECK ((t1 = clone (worker, (void *) 1, stacks[1] + sizeof stacks[1]))
+         != TID_ERROR, "clone thread 1");
+  ready = 1;
+  futex_wake (&ready, 1);
+
+  CHECK (join (t0) == 10, "join thread 0");
+  CHECK (join (t1) == 11, "join thread 1");
+  CHECK (join (t1) == -1, "join thread 1 again must fail");
+  CHECK (slots[0] == 1 && slots[1] == 2, "threads wrote shared memory");
+  CHECK (first == sample[0], "thread read from shared fd");
+}
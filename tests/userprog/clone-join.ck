@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(clone-join) begin
+(clone-join) open "sample.txt"
+(clone-join) clone thread 0
+(clone-join) clone thread 1
+(clone-join) join thread 0
+(clone-join) join thread 1
+(clone-join) join thread 1 again must fail
+(clone-join) threads wrote shared memory
+(clone-join) thread read from shared fd
+(clone-join) end
+clone-join: exit(0)
+EOF
+pass;
@@ -0,0 +1,22 @@
+/* Checks the futex_wait and futex_wake calls a single thread can
+   exercise: a value mismatch returns at once, a timeout expires,
+   and waking a word nobody sleeps on wakes no one. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static int word;
+
+void
+test_main (void) 
+{
+  word = 1;
+  CHECK (futex_wait (&word, 0, 0) == FUTEX_CHANGED,
+         "futex_wait with a stale value");
+  CHECK (futex_wait (&word, 1, 5) == FUTEX_TIMEDOUT,
+         "futex_wait for 5 ticks");
+  CHECK (futex_wake (&word, 1) == 0, "futex_wake with no waiters");
+  CHECK (futex_wait ((int *) ((char *) &word + 1), 1, 5) == -1,
+         "futex_wait on a misaligned word must fail");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(futex) begin
+(futex) futex_wait with a stale value
+(futex) futex_wait for 5 ticks
+(futex) futex_wake with no waiters
+(futex) futex_wait on a misaligned word must fail
+(futex) end
+futex: exit(0)
+EOF
+pass;
@@ -0,0 +1,36 @@
+/* Checks that getrusage reports a thread's own usage and rolls a
+   child's usage into its parent when the parent waits for it. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  struct rusage self, children;
+  int pid;
+
+  if ((pid = fork ("child"))){
+    CHECK (wait (pid) == 0, "wait for child");
+    CHECK (getrusage (RUSAGE_CHILDREN, &children) == 0,
+           "getrusage (RUSAGE_CHILDREN)");
+    if (children.utime < 2)
+      fail ("child ran %lld user ticks, expected at least 2",
+            children.utime);
+    CHECK (getrusage (RUSAGE_SELF, &self) == 0, "getrusage (RUSAGE_SELF)");
+    if (self.nvcsw < 1)
+      fail ("parent never blocked, though it waited for its child");
+    CHECK (getrusage (1, &self) == -1, "getrusage (1) must fail");
+  } else {
+    volatile int spin;
+
+    /* Burn user time until at least 2 ticks have been charged. */
+    do {
+      for (spin = 0; spin < 100000; spin++)
+        continue;
+      getrusage (RUSAGE_SELF, &self);
+    } while (self.utime < 2);
+    exit (0);
+  }
+}
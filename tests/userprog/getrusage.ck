@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(getrusage) begin
+child: exit(0)
+(getrusage) wait for child
+(getrusage) getrusage (RUSAGE_CHILDREN)
+(getrusage) getrusage (RUSAGE_SELF)
+(getrusage) getrusage (1) must fail
+(getrusage) end
+getrusage: exit(0)
+EOF
+pass;
@@ -17,12 +17,16 @@
 #include "devices/vga.h"
 #include "threads/interrupt.h"
 #include "threads/io.h"
+#include "threads/lockprof.h"
 #include "threads/loader.h"
 #include "threads/malloc.h"
 #include "threads/mmu.h"
 #include "threads/palloc.h"
+#include "threads/profile.h"
 #include "threads/pte.h"
+#include "threads/schedtrace.h"
 #include "threads/thread.h"
+#include "threads/vmalloc.h"
 #ifdef USERPROG
 #include "userprog/exception.h"
 #include "userprog/gdt.h"
@@ -95,6 +99,7 @@ int main(void) {
     mem_end = palloc_init();        // 메모리 크기 결정
     malloc_init();  
     paging_init(mem_end);           // 메모리 initialize
+    vmalloc_init(mem_end);          // 큰 malloc을 위한 커널 가상 주소 영역
     
 #ifdef USERPROG
     tss_init();
@@ -115,6 +120,8 @@ int main(void) {
     thread_start();
     serial_init_queue();
     timer_calibrate();
+    sched_trace_init();
+    profile_init();
 
 #ifdef FILESYS
     /* 파일 시스템을 초기화합니다. */
@@ -246,6 +253,22 @@ static char **parse_options(char **argv) {
             random_init(atoi(value));
         else if (!strcmp(name, "-mlfqs"))  // 다중 레벨 피드백 큐 스케줄러 사용 옵션
             thread_mlfqs = true;
+        else if (!strcmp(name, "-cfs"))  // 가중치 공정 스케줄러 사용 옵션
+            thread_cfs = true;
+        else if (!strcmp(name, "-tickless"))  // 유휴 상태에서 주기적 틱 중단 옵션
+            timer_tickless = true;
+        else if (!strcmp(name, "-schedtrace"))  // 스케줄러 추적 옵션
+            sched_trace_enabled = true;
+        else if (!strcmp(name, "-irqsoff"))  // 인터럽트가 꺼진 구간 추적 옵션
+            intr_trace_enabled = true;
+        else if (!strcmp(name, "-profile")) {  // 표본 추출 프로파일러 옵션
+            profile_interval = value != NULL ? atoi(value) : 1;
+            /* 프로필 헤더는 초당 표본 수를 정수로 기록하므로 1초보다 길게 잡지 않습니다. */
+            /* The profile header records whole samples per second,
+               so sample at least once a second. */
+            if (profile_interval > TIMER_FREQ)
+                profile_interval = TIMER_FREQ;
+        }
 #ifdef USERPROG
         else if (!strcmp(name, "-ul"))  // 사용자 페이지 제한 설정
             user_page_limit = atoi(value);
@@ -255,6 +278,8 @@ static char **parse_options(char **argv) {
         else
             PANIC("unknown option `%s' (use -h for help)", name);  // 알려지지 않은 옵션 처리
     }
+    if (thread_mlfqs && thread_cfs)
+        PANIC("-mlfqs and -cfs are mutually exclusive");
 
     return argv;  // 옵션이 아닌 첫 인자를 가리키는 포인터 반환
 }
@@ -295,6 +320,8 @@ static void run_actions(char **argv) {
         {"run", 2, run_task},
 #ifdef FILESYS
         {"ls", 1, fsutil_ls}, {"cat", 2, fsutil_cat}, {"rm", 2, fsutil_rm}, {"put", 2, fsutil_put}, {"get", 2, fsutil_get},
+        {"schedtrace", 2, sched_trace_save},
+        {"profile", 2, profile_save},
 #endif
         {NULL, 0, NULL},
     };
@@ -345,6 +372,8 @@ static void usage(void) {
         "Use these actions indirectly via `pintos' -g and -p options:\n"  //
         "  put FILE           Put FILE into file system from scratch disk.\n"
         "  get FILE           Get FILE from file system into scratch disk.\n"
+        "  schedtrace FILE    Save the scheduler trace to FILE; `get' it after.\n"
+        "  profile FILE       Save the profile samples to FILE; `get' it after.\n"
 #endif
         "\nOptions:\n"
         "  -h                 Print this help message and power off.\n"     // 도움말
@@ -352,6 +381,12 @@ static void usage(void) {
         "  -f                 Format file system disk during startup.\n"    // 시작 시 파일 시스템 디스크를 포맷
         "  -rs=SEED           Set random number seed to SEED.\n"            // 난수 시드를 SEED 로 설정
         "  -mlfqs             Use multi-level feedback queue scheduler.\n"  // 멀티 레벨 피드백 큐 스케줄러를 사용합니다.
+        "  -cfs               Use weighted fair share scheduler.\n"         // 가중치 공정 스케줄러를 사용합니다.
+        "  -tickless          Stop the periodic timer tick while idle.\n"   // 유휴 상태에서 주기적 틱을 멈춥니다.
+        "  -schedtrace        Trace the scheduler, dump at power off.\n"    // 스케줄러 사건을 추적해 종료 시 출력합니다.
+        "  -irqsoff           Time interrupts-off windows, dump at power off.\n"  // 인터럽트가 꺼진 구간을 재어 종료 시 출력합니다.
+        "  -profile[=N]       Sample the running code every N timer ticks,\n"   // N 타이머 틱마다 실행 중인 코드를 표본 추출합니다.
+        "                     N is capped at one second's worth of ticks.\n"   // N은 1초에 해당하는 틱 수를 넘지 않습니다.
 #ifdef USERPROG
         "  -ul=COUNT          Limit user memory to COUNT pages.\n"  // 사용자 메모리를 count 페이지로 제한
 #endif
@@ -381,8 +416,17 @@ void power_off(void) {
 static void print_stats(void) {
     timer_print_stats();   // 타이머 통계
     thread_print_stats();  // 스레드 통계
+    sched_trace_print_stats();  // 스케줄러 추적
+    intr_print_stats();         // 인터럽트가 꺼진 구간
+    profile_print_stats();      // 표본 추출 프로파일
+    palloc_print_stats();       // 페이지 할당자 단편화
+    malloc_print_stats();       // 캐시별 할당 횟수
+    vmalloc_print_stats();      // 커널 가상 주소 영역
 #ifdef FILESYS
     disk_print_stats();  // 디스크 통계
+#endif
+#ifdef LOCK_PROFILE
+    lock_print_stats();  // 락 경합 통계
 #endif
     console_print_stats();  // 콘솔 통계
     kbd_print_stats();      // 키보드 통계
@@ -4,6 +4,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "devices/timer.h"
 #include "intrinsic.h"
@@ -15,6 +16,7 @@
 #include "threads/vaddr.h"
 #ifdef USERPROG
 #include "userprog/gdt.h"
+#include "userprog/process.h"
 #endif
 
 /* x86_64 인터럽트의 수입니다. */
@@ -138,6 +140,55 @@ static bool yield_on_return; /* 인터럽트 반환 시에 프로세스 전환
 static void pic_init(void);                /* PIC 초기화 함수 */
 static void pic_end_of_interrupt(int irq); /* 인터럽트 처리 완료를 PIC에 알리는 함수 */
 
+/* 인터럽트가 꺼져 있던 구간 추적. 커널 명령줄 옵션 "-irqsoff"로 켭니다.
+   인터럽트를 끈 곳과 다시 켠 곳을 짝지어 TSC로 구간의 길이를 재고, 끈 곳마다
+   가장 긴 구간을 기억합니다. 인터럽트가 꺼진 채로 갱신하며, 이 모듈의 다른
+   상태처럼 CPU 하나를 가정합니다.
+   set_level()을 거치지 않고 인터럽트를 켜는 곳, 즉 유휴 스레드의 `sti; hlt'와
+   do_iret()의 iretq는 intr_trace_stop()으로 구간을 닫습니다. 인터럽트 스텁의
+   iretq는 intr_handler()가 닫습니다. syscall 진입 때 하드웨어가 끈 구간은
+   열지 않으므로 재지 않습니다. */
+/* Interrupts-off tracing, turned on by kernel command-line
+   option "-irqsoff".  Each place that turns interrupts off is
+   paired with the place that turns them back on, the window in
+   between is timed with the TSC, and the longest window is kept
+   for each place that opened one.  Updated with interrupts off;
+   like the rest of this module, assumes a single CPU.
+
+   The places that turn interrupts on without going through
+   set_level(), namely the idle thread's `sti; hlt' and the
+   iretq in do_iret(), close the window with intr_trace_stop().
+   intr_handler() closes it for the iretq in the interrupt
+   stubs.  The short stretch that the `syscall' instruction runs
+   with interrupts masked never opens a window and is not
+   timed. */
+bool intr_trace_enabled;
+
+/* 기억하는 여는 곳의 수. */
+/* Number of opening sites remembered. */
+#define IRQSOFF_SITES 16
+
+/* 인터럽트를 끈 곳 하나의 기록. 시간은 TSC 사이클입니다. */
+/* Record of one place that turned interrupts off.  Times are in
+   TSC cycles. */
+struct irqsoff_site {
+    void *begin;                /* 인터럽트를 끈 곳. *//* Where interrupts went off. */
+    void *end;                  /* 가장 긴 구간을 닫은 곳. *//* Where the longest window ended. */
+    unsigned long long max;     /* 가장 긴 구간. *//* Longest window. */
+    unsigned long long total;   /* 구간 길이의 합. *//* Sum of window lengths. */
+    unsigned long long cnt;     /* 구간 수. *//* # of windows. */
+};
+
+static struct irqsoff_site irqsoff_sites[IRQSOFF_SITES];
+static unsigned long long irqsoff_windows; /* 잰 구간 수. *//* # of windows timed. */
+static bool irqsoff_open;       /* 구간을 재는 중인가? *//* Timing a window? */
+static uint64_t irqsoff_start;  /* 구간이 열린 시각. *//* When the window opened. */
+static void *irqsoff_begin;     /* 구간을 연 곳. *//* Where the window opened. */
+
+static void irqsoff_on(void *site);
+static void irqsoff_off(void *site);
+static enum intr_level set_level(enum intr_level, void *site);
+
 /* 인터럽트 핸들러 함수입니다. */
 /* Interrupt handlers. */
 void intr_handler(struct intr_frame *args);
@@ -162,14 +213,44 @@ enum intr_level intr_get_level(void) {
 /* Enables or disables interrupts as specified by LEVEL and
    returns the previous interrupt status. */
 enum intr_level intr_set_level(enum intr_level level) {
-    return level == INTR_ON ? intr_enable() : intr_disable();
+    return set_level(level, __builtin_return_address(0));
 }
 
 /* 인터럽트를 활성화하고 이전 인터럽트 상태를 반환합니다. */
 /* Enables interrupts and returns the previous interrupt status. */
 enum intr_level intr_enable(void) {
+    return set_level(INTR_ON, __builtin_return_address(0));
+}
+
+/* 인터럽트 비활성화하고 이전 인터럽트 상태를 반환합니다. */
+/* Disables interrupts and returns the previous interrupt status. */
+enum intr_level intr_disable(void) {
+    return set_level(INTR_OFF, __builtin_return_address(0));
+}
+
+/* 인터럽트를 LEVEL로 만들고 이전 인터럽트 상태를 반환합니다. SITE는 호출한 곳이며
+   인터럽트가 꺼져 있던 구간을 추적하는 데 씁니다. */
+/* Enables or disables interrupts as specified by LEVEL and
+   returns the previous interrupt status.  SITE is the caller,
+   used for interrupts-off tracing. */
+static enum intr_level set_level(enum intr_level level, void *site) {
     enum intr_level old_level = intr_get_level();
+
+    if (level == INTR_OFF) {
+        /* 인터럽트 플래그를 지워서 인터럽트를 비활성화합니다.
+           [IA32-v2b] "CLI" 및 [IA32-v3a] 5.8.1 "Maskable Hardware Interrupts 마스킹" 참조. */
+        /* Disable interrupts by clearing the interrupt flag.
+           See [IA32-v2b] "CLI" and [IA32-v3a] 5.8.1 "Masking Maskable
+           Hardware Interrupts". */
+        asm volatile("cli" : : : "memory");
+        if (old_level == INTR_ON && intr_trace_enabled)
+            irqsoff_on(site);
+        return old_level;
+    }
+
     ASSERT(!intr_context());
+    if (old_level == INTR_OFF && intr_trace_enabled)
+        irqsoff_off(site);
 
     /* 인터럽트 플래그를 설정하여 인터럽트를 활성화합니다.
 
@@ -184,20 +265,105 @@ enum intr_level intr_enable(void) {
     return old_level;
 }
 
-/* 인터럽트 비활성화하고 이전 인터럽트 상태를 반환합니다. */
-/* Disables interrupts and returns the previous interrupt status. */
-enum intr_level intr_disable(void) {
-    enum intr_level old_level = intr_get_level();
+/* SITE에서 인터럽트가 꺼졌으므로 구간을 엽니다. */
+/* Opens a window: SITE has just turned interrupts off. */
+static void irqsoff_on(void *site) {
+    irqsoff_open = true;
+    irqsoff_start = rdtsc();
+    irqsoff_begin = site;
+}
 
-    /* 인터럽트 플래그를 지워서 인터럽트를 비활성화합니다.
-       [IA32-v2b] "CLI" 및 [IA32-v3a] 5.8.1 "Maskable Hardware Interrupts 마스킹" 참조. */
+/* SITE가 인터럽트를 다시 켜려 하므로 열린 구간을 닫고 기록합니다. 기록할 자리가
+   없으면 가장 긴 구간이 가장 짧은 곳을 더 긴 구간을 연 곳으로 바꿉니다. */
+/* Closes the open window, if any, as SITE is about to turn
+   interrupts back on, and records it.  If the table is full,
+   the entry with the shortest longest window gives way to a
+   site whose window is longer. */
+static void irqsoff_off(void *site) {
+    unsigned long long len;
+    struct irqsoff_site *s, *victim = NULL;
+
+    if (!irqsoff_open)
+        return;
+    irqsoff_open = false;
+    len = rdtsc() - irqsoff_start;
+    irqsoff_windows++;
+
+    for (s = irqsoff_sites; s < irqsoff_sites + IRQSOFF_SITES; s++) {
+        if (s->begin == irqsoff_begin || s->begin == NULL)
+            break;
+        if (victim == NULL || s->max < victim->max)
+            victim = s;
+    }
+    if (s == irqsoff_sites + IRQSOFF_SITES) {
+        if (len <= victim->max)
+            return;
+        s = victim;
+        s->begin = NULL;
+    }
+    if (s->begin == NULL) {
+        s->begin = irqsoff_begin;
+        s->max = s->total = s->cnt = 0;
+    }
+    s->cnt++;
+    s->total += len;
+    if (len >= s->max) {
+        s->max = len;
+        s->end = site;
+    }
+}
 
-    /* Disable interrupts by clearing the interrupt flag.
-       See [IA32-v2b] "CLI" and [IA32-v3a] 5.8.1 "Masking Maskable
-       Hardware Interrupts". */
-    asm volatile("cli" : : : "memory");
+/* 호출한 곳이 set_level()을 거치지 않고 곧 인터럽트를 켜므로, 열린 구간을
+   그곳에서 닫습니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Closes the open window at the caller, which is about to turn
+   interrupts on without going through set_level().  Interrupts
+   must be off. */
+void intr_trace_stop(void) {
+    ASSERT(intr_get_level() == INTR_OFF);
 
-    return old_level;
+    if (intr_trace_enabled)
+        irqsoff_off(__builtin_return_address(0));
+}
+
+/* 두 기록을 가장 긴 구간의 내림차순으로 비교합니다. */
+/* Orders two records by longest window, longest first. */
+static int irqsoff_longer(const void *a_, const void *b_) {
+    const struct irqsoff_site *a = a_;
+    const struct irqsoff_site *b = b_;
+
+    return a->max < b->max ? 1 : a->max > b->max ? -1 : 0;
+}
+
+/* 인터럽트가 꺼져 있던 가장 긴 구간들을 긴 순서로 출력합니다. 주소는 `backtrace'
+   프로그램으로 함수 이름으로 바꿀 수 있습니다. 추적은 계속되므로 기록을 복사해서
+   정렬합니다. */
+/* Prints the longest interrupts-off windows, longest first.
+   The `backtrace' program turns the addresses into function
+   names.  Tracing goes on meanwhile, so a snapshot of the
+   records is sorted rather than the records themselves. */
+void intr_print_stats(void) {
+    static struct irqsoff_site sites[IRQSOFF_SITES];
+    unsigned long long windows;
+    enum intr_level old_level;
+    size_t cnt, i;
+
+    if (!intr_trace_enabled)
+        return;
+
+    old_level = intr_disable();
+    for (cnt = 0; cnt < IRQSOFF_SITES && irqsoff_sites[cnt].begin != NULL; cnt++)
+        sites[cnt] = irqsoff_sites[cnt];
+    windows = irqsoff_windows;
+    intr_set_level(old_level);
+
+    qsort(sites, cnt, sizeof *sites, irqsoff_longer);
+    printf("Interrupts off: %llu windows, longest first, in TSC cycles\n", windows);
+    for (i = 0; i < cnt; i++) {
+        struct irqsoff_site *s = &sites[i];
+
+        printf("  %p..%p: max %llu, %llu windows, avg %llu\n", s->begin, s->end, s->max,
+               s->cnt, s->total / s->cnt);
+    }
 }
 
 /* 인터럽트 시스템을 초기화합니다. */
@@ -422,6 +588,14 @@ void intr_handler(struct intr_frame *frame) {
         yield_on_return = false;
     }
 
+    /* 인터럽트 게이트가 인터럽트를 껐다면 구간을 엽니다. 핸들러가 인터럽트를 켜지
+       않으면 iretq가 다시 켜므로 아래에서 닫습니다. */
+    /* If an interrupt gate has just turned interrupts off, open a
+       window.  Unless the handler turns them back on itself, iretq
+       will, so it is closed below. */
+    if (intr_trace_enabled && (frame->eflags & FLAG_IF) && intr_get_level() == INTR_OFF)
+        irqsoff_on(intr_handlers[frame->vec_no]);
+
     /* 인터럽트의 핸들러를 호출합니다. */
     /* Invoke the interrupt's handler. */
     handler = intr_handlers[frame->vec_no];
@@ -453,6 +627,22 @@ void intr_handler(struct intr_frame *frame) {
         if (yield_on_return)
             thread_yield();
     }
+
+    if (intr_trace_enabled && (frame->eflags & FLAG_IF) && intr_get_level() == INTR_OFF)
+        irqsoff_off(intr_handlers[frame->vec_no]);
+
+#ifdef USERPROG
+    /* 같은 프로세스의 다른 스레드가 exit()했다면 사용자 모드로 돌아가지 않고 끝납니다.
+       사용자 코드만 돌던 스레드도 이렇게 늦어도 다음 타이머 인터럽트에서 끝납니다. */
+    /* If another thread of our process called exit(), end here
+       instead of returning to user mode.  This way a thread busy
+       in user code ends by the next timer interrupt at the
+       latest. */
+    if ((frame->cs & 3) == 3 && process_exiting()) {
+        intr_enable();
+        thread_exit();
+    }
+#endif
 }
 
 /* 디버깅을 위해 인터럽트 프레임 F를 콘솔에 덤프합니다. */
@@ -0,0 +1,200 @@
+#include "threads/lockprof.h"
+
+#ifdef LOCK_PROFILE
+#include <debug.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+
+/* 기록할 수 있는 락의 수. 2의 거듭제곱이어야 합니다. */
+/* Number of locks that can be recorded.  Must be a power of
+   2. */
+#define LOCK_PROF_MAX 256
+
+/* 락마다 기억하는 대기 호출 지점의 수. */
+/* Waiter call sites remembered per lock. */
+#define LOCK_PROF_SITES 4
+
+/* 보고서에 출력하는 락의 수. */
+/* Number of locks printed in the report. */
+#define LOCK_PROF_TOP 10
+
+/* 락을 기다린 호출 지점. */
+/* A call site that waited for a lock. */
+struct lock_site {
+    void *pc;                   /* 획득 함수의 반환 주소. *//* Return address of the acquire call. */
+    unsigned long long cnt;     /* 기다린 횟수 (추정치). *//* Times it waited (estimate). */
+    unsigned long long wait;    /* 기다린 TSC 사이클 합. *//* Total TSC cycles waited. */
+};
+
+/* 락 하나의 경합 기록. 시간은 모두 TSC 사이클입니다. 갱신은 락을 보유한 쪽만 하므로
+   락 자체가 이 기록을 보호합니다. 읽기-쓰기 락은 읽는 쪽이 여럿일 수 있어 guard를
+   잡고 갱신하며, 보유 시간은 쓰는 쪽만 셉니다. */
+/* Contention record of a single lock.  All times are in TSC
+   cycles.  Only the holder updates it, so the lock itself
+   protects its record.  Reader-writer locks, which may have many
+   readers at once, update it under their guard instead and count
+   hold times for writers only. */
+struct lock_prof {
+    const void *lock;           /* 키: 락의 주소. *//* Key: address of the lock. */
+    const char *kind;           /* 락의 종류. *//* "lock", "rwlock" or "spinlock". */
+    const char *name;           /* 락의 이름. *//* Name of the lock. */
+    unsigned long long acquired; /* 획득 횟수. *//* # of acquisitions. */
+    unsigned long long contended; /* 기다려야 했던 획득 횟수. *//* # that had to wait. */
+    unsigned long long wait_total;
+    unsigned long long wait_max;
+    unsigned long long hold_total;
+    unsigned long long hold_max;
+    struct lock_site sites[LOCK_PROF_SITES];
+};
+
+/* 락 주소로 찾는 개방 주소법 해시 테이블. 항목은 지워지지 않으며, 같은 주소에
+   다른 이름의 락이 초기화되면 기록을 새로 시작합니다. */
+/* Open-addressing hash table keyed by lock address.  Entries
+   are never removed; if a lock with a different name is
+   initialized at a recorded address, its record starts over. */
+static struct lock_prof lock_profs[LOCK_PROF_MAX];
+static struct spinlock lock_profs_lock = {0, NULL, "lockprof"};
+static unsigned lock_prof_dropped;
+
+static void site_record(struct lock_prof *, void *pc, uint64_t wait);
+static int wait_greater(const void *, const void *);
+
+/* 종류가 KIND이고 이름이 NAME인 LOCK의 기록을 찾거나 만들어 반환합니다.
+   테이블이 가득 차면 NULL을 반환하고, 그 락은 기록하지 않습니다. */
+/* Finds or creates the record of LOCK, of type KIND and named
+   NAME, and returns it.  Returns a null pointer, leaving LOCK
+   unrecorded, if the table is full. */
+struct lock_prof *lock_prof_register(const void *lock, const char *kind, const char *name) {
+    uintptr_t h = ((uintptr_t)lock >> 3) * 0x9e3779b97f4a7c15ULL;
+    struct lock_prof *prof = NULL;
+    enum intr_level old_level;
+    size_t i;
+
+    old_level = intr_disable();
+    spinlock_acquire(&lock_profs_lock);
+    for (i = 0; i < LOCK_PROF_MAX; i++) {
+        struct lock_prof *p = &lock_profs[(h + i) & (LOCK_PROF_MAX - 1)];
+
+        if (p->lock == NULL || p->lock == lock) {
+            if (p->lock == NULL || strcmp(p->kind, kind) || strcmp(p->name, name)) {
+                memset(p, 0, sizeof *p);
+                p->lock = lock;
+                p->kind = kind;
+                p->name = name;
+            }
+            prof = p;
+            break;
+        }
+    }
+    if (prof == NULL)
+        lock_prof_dropped++;
+    spinlock_release(&lock_profs_lock);
+    intr_set_level(old_level);
+    return prof;
+}
+
+/* 기록이 P인 락을 얻었음을 기록합니다. CONTENDED이면 WAIT 사이클 동안
+   기다렸으며, CALLER는 획득 함수를 부른 곳입니다. P가 NULL이면 아무것도 하지 않습니다. */
+/* Records that the lock whose record is P was acquired.  If
+   CONTENDED, the acquirer waited WAIT cycles; CALLER is where
+   the acquire function was called from.  Does nothing if P is
+   null. */
+void lock_prof_acquired(struct lock_prof *p, bool contended, uint64_t wait, void *caller) {
+    if (p == NULL)
+        return;
+    p->acquired++;
+    if (!contended)
+        return;
+    p->contended++;
+    p->wait_total += wait;
+    if (wait > p->wait_max)
+        p->wait_max = wait;
+    site_record(p, caller, wait);
+}
+
+/* 기록이 P인 락을 HOLD 사이클 동안 보유한 뒤 놓으려 함을 기록합니다. */
+/* Records that the lock whose record is P is about to be
+   released after being held for HOLD cycles.  Does nothing if
+   P is null. */
+void lock_prof_released(struct lock_prof *p, uint64_t hold) {
+    if (p == NULL)
+        return;
+    p->hold_total += hold;
+    if (hold > p->hold_max)
+        p->hold_max = hold;
+}
+
+/* 총 대기 시간이 긴 순서로 상위 락들의 기록을 출력합니다. */
+/* Prints the records of the locks with the most total wait
+   time. */
+void lock_print_stats(void) {
+    static struct lock_prof *sorted[LOCK_PROF_MAX];
+    size_t cnt = 0;
+    size_t i, j;
+
+    for (i = 0; i < LOCK_PROF_MAX; i++)
+        if (lock_profs[i].acquired > 0)
+            sorted[cnt++] = &lock_profs[i];
+    qsort(sorted, cnt, sizeof *sorted, wait_greater);
+
+    printf("Lock profile: %zu locks used, %u unrecorded, times in TSC cycles\n", cnt,
+           lock_prof_dropped);
+    for (i = 0; i < cnt && i < LOCK_PROF_TOP; i++) {
+        struct lock_prof *p = sorted[i];
+        const char *name = p->name[0] == '&' ? p->name + 1 : p->name;
+
+        printf("  %-8s %-16s %p: %llu acquired, %llu contended, wait %llu (max %llu), "
+               "hold %llu (max %llu)\n",
+               p->kind, name, p->lock, p->acquired, p->contended, p->wait_total, p->wait_max,
+               p->hold_total, p->hold_max);
+        for (j = 0; j < LOCK_PROF_SITES && p->sites[j].pc != NULL; j++)
+            printf("    waiter %p: %llu times, wait %llu\n", p->sites[j].pc,
+                   p->sites[j].cnt, p->sites[j].wait);
+    }
+}
+
+/* P의 대기 호출 지점 표에 PC가 WAIT 사이클 기다렸음을 더합니다. 표가 가득 차면
+   가장 적게 기다린 지점을 PC로 바꾸고 그 횟수를 물려받게 하여 (space-saving),
+   자주 기다리는 지점이 결국 남도록 합니다. 표는 횟수가 많은 순서로 유지합니다. */
+/* Adds a wait of WAIT cycles by PC to the waiter call sites of
+   P.  When the table is full, the site with the fewest waits
+   is replaced by PC, which inherits its count ("space-saving"),
+   so that frequent waiters end up in the table.  The table is
+   kept sorted by count, most first. */
+static void site_record(struct lock_prof *p, void *pc, uint64_t wait) {
+    struct lock_site *s = p->sites;
+    size_t i;
+
+    for (i = 0; i < LOCK_PROF_SITES - 1; i++)
+        if (s[i].pc == pc || s[i].pc == NULL)
+            break;
+    if (s[i].pc != pc) {
+        s[i].pc = pc;
+        s[i].wait = 0;
+    }
+    s[i].cnt++;
+    s[i].wait += wait;
+
+    for (; i > 0 && s[i].cnt > s[i - 1].cnt; i--) {
+        struct lock_site tmp = s[i];
+
+        s[i] = s[i - 1];
+        s[i - 1] = tmp;
+    }
+}
+
+/* 총 대기 시간의 내림차순으로 두 기록을 비교합니다. */
+/* Orders two records by total wait time, most first. */
+static int wait_greater(const void *a_, const void *b_) {
+    const struct lock_prof *a = *(struct lock_prof *const *)a_;
+    const struct lock_prof *b = *(struct lock_prof *const *)b_;
+
+    if (a->wait_total != b->wait_total)
+        return a->wait_total < b->wait_total ? 1 : -1;
+    return a->contended < b->contended ? 1 : a->contended > b->contended ? -1 : 0;
+}
+#endif /* LOCK_PROFILE */
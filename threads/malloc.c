@@ -5,142 +5,278 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "threads/interrupt.h"
 #include "threads/palloc.h"
 #include "threads/synch.h"
+#include "threads/thread.h"
 #include "threads/vaddr.h"
-
-/* A simple implementation of malloc().
-
-   The size of each request, in bytes, is rounded up to a power
-   of 2 and assigned to the "descriptor" that manages blocks of
-   that size.  The descriptor keeps a list of free blocks.  If
-   the free list is nonempty, one of its blocks is used to
-   satisfy the request.
-
-   Otherwise, a new page of memory, called an "arena", is
-   obtained from the page allocator (if none is available,
-   malloc() returns a null pointer).  The new arena is divided
-   into blocks, all of which are added to the descriptor's free
-   list.  Then we return one of the new blocks.
-
-   When we free a block, we add it to its descriptor's free list.
-   But if the arena that the block was in now has no in-use
-   blocks, we remove all of the arena's blocks from the free list
-   and give the arena back to the page allocator.
-
-   We can't handle blocks bigger than 2 kB using this scheme,
-   because they're too big to fit in a single page with a
-   descriptor.  We handle those by allocating contiguous pages
-   with the page allocator and sticking the allocation size at
-   the beginning of the allocated block's arena header. */
-
-/* Descriptor. */
-struct desc {
-	size_t block_size;          /* Size of each element in bytes. */
-	size_t blocks_per_arena;    /* Number of blocks in an arena. */
-	struct list free_list;      /* List of free blocks. */
-	struct lock lock;           /* Lock. */
+#include "threads/vmalloc.h"
+
+/* A slab allocator with per-CPU magazines.
+
+   Memory is handed out by "caches", each of which serves
+   objects of a single size.  malloc() rounds each request up to
+   the nearest of a set of size classes, each with its own
+   cache.  The classes are multiples of 16 bytes, which keeps
+   objects 16-byte aligned, but not all powers of 2: most divide
+   the usable part of a page exactly, and above 32 bytes none is
+   more than 1.5 times the one below it, which keeps internal
+   fragmentation down.  Other kernel code may create caches of its own for
+   objects of a given type with kmem_cache_create().
+
+   Each cache obtains memory from the page allocator one page,
+   called a "slab", at a time.  A slab begins with a header that
+   identifies its cache and keeps a bitmap of its free objects,
+   so finding or freeing an object touches only the header, not
+   the (possibly cold) objects themselves.  Slabs with free
+   objects are kept on the cache's list, which the cache's lock
+   protects.
+
+   In front of the slabs, each CPU has a pair of "magazines" per
+   cache, small stacks of free objects.  Allocation pops an
+   object off the loaded magazine and freeing pushes one onto
+   it, with interrupts off but without taking any lock.  When
+   the loaded magazine runs empty on allocation (or full on
+   free), it is swapped with the previous one if that one is
+   full (or empty).  The previous magazine is therefore always
+   either full or empty, and only when both magazines are empty
+   (or full) does the CPU take the cache's lock to refill (or
+   flush) one of them in a single pass.  A CPU that alternates
+   between allocating and freeing thus stays off the lock.
+
+   A cache may have a constructor, which is applied to each
+   object once, when its slab is created.  Objects must be freed
+   in their constructed state, so a constructor can set up
+   state that is the same for every free object and that
+   allocation would otherwise have to redo each time.
+
+   We can't handle blocks bigger than the largest size class
+   using this scheme, because they're too big to fit in a page
+   with a slab header.  We handle those by allocating contiguous
+   pages with the page allocator and sticking the allocation
+   size at the beginning of the allocated block's header.  If
+   physical memory is too fragmented for that, the pages come
+   from vmalloc() instead, which maps scattered pages at
+   contiguous virtual addresses. */
+
+/* Magic number for detecting slab corruption. */
+#define SLAB_MAGIC 0x9a548eed
+
+/* Most objects a slab can hold: one per bit of its free map. */
+#define SLAB_MAX_OBJS 256
+
+/* Slab header, at the start of each slab's page. */
+struct slab {
+	unsigned magic;             /* Always set to SLAB_MAGIC. */
+	unsigned free_cnt;          /* Free objects; pages in big block. */
+	struct kmem_cache *cache;   /* Owning cache, null for big block. */
+	struct list_elem elem;      /* Cache's slab list, if free_cnt > 0. */
+	uint64_t free_map[SLAB_MAX_OBJS / 64]; /* Set bits are free objects. */
 };
 
-/* Magic number for detecting arena corruption. */
-#define ARENA_MAGIC 0x9a548eed
+/* Most objects a magazine holds. */
+#define MAG_ROUNDS 14
 
-/* Arena. */
-struct arena {
-	unsigned magic;             /* Always set to ARENA_MAGIC. */
-	struct desc *desc;          /* Owning descriptor, null for big block. */
-	size_t free_cnt;            /* Free blocks; pages in big block. */
+/* A magazine: a stack of free objects. */
+struct magazine {
+	size_t rounds;              /* Number of objects in OBJS. */
+	void *objs[MAG_ROUNDS];     /* Objects, top of stack last. */
 };
 
-/* Free block. */
-struct block {
-	struct list_elem free_elem; /* Free list element. */
+/* A CPU's view of a cache.  Only that CPU uses it, with
+   interrupts off. */
+struct kmem_cpu {
+	struct magazine *loaded;    /* Magazine in use. */
+	struct magazine *prev;      /* Either full or empty. */
+	struct magazine mags[2];    /* Storage for LOADED and PREV. */
+	long long allocs;           /* Number of allocations. */
+	long long refills;          /* Times the magazines ran dry. */
 };
 
-/* Our set of descriptors. */
-static struct desc descs[10];   /* Descriptors. */
-static size_t desc_cnt;         /* Number of descriptors. */
+/* Cache of objects of one size. */
+struct kmem_cache {
+	const char *name;           /* Name (for statistics). */
+	size_t size;                /* Size of each object in bytes. */
+	size_t objs_per_slab;       /* Number of objects in a slab. */
+	size_t mag_size;            /* Most objects in a magazine. */
+	void (*ctor) (void *);      /* Constructor, or null. */
+	struct list_elem elem;      /* Element in all_caches. */
+	struct kmem_cpu cpus[NCPU_MAX]; /* Per-CPU magazines. */
+
+	struct spinlock lock;       /* Protects the fields below. */
+	struct list slabs;          /* Slabs with free objects. */
+	size_t slab_cnt;            /* Number of slabs. */
+	size_t empty_cnt;           /* Slabs with no object in use. */
+};
 
-static struct arena *block_to_arena (struct block *);
-static struct block *arena_to_block (struct arena *, size_t idx);
+/* Slabs with no object in use kept per cache, to spare the
+   page allocator when usage hovers around a slab boundary. */
+#define SLAB_EMPTY_MAX 1
 
-/* Initializes the malloc() descriptors. */
+/* Size classes.  Most divide PGSIZE - sizeof (struct slab)
+   exactly. */
+static const size_t class_sizes[] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 144, 192, 224, 256, 288,
+	336, 448, 512, 576, 672, 1008, 1344, 2016,
+};
+#define CLASS_CNT (sizeof class_sizes / sizeof *class_sizes)
+#define CLASS_MAX 2016
+
+/* Cache for each size class, and the index into it of the
+   smallest class of at least N * 16 bytes. */
+static struct kmem_cache class_caches[CLASS_CNT];
+static uint8_t class_index[CLASS_MAX / 16 + 1];
+
+/* All caches, for statistics.  Caches are created during
+   initialization and never destroyed. */
+static struct list all_caches;
+
+static void cache_init (struct kmem_cache *, const char *name, size_t size,
+		void (*ctor) (void *));
+static bool cache_grow (struct kmem_cache *);
+static size_t slabs_take (struct kmem_cache *, void **objs, size_t cnt);
+static void slabs_put (struct kmem_cache *, void **objs, size_t cnt);
+static struct slab *block_to_slab (void *);
+static void *slab_to_block (struct slab *, size_t idx);
+
+/* Initializes the size class caches. */
 void
 malloc_init (void) {
-	size_t block_size;
-
-	for (block_size = 16; block_size < PGSIZE / 2; block_size *= 2) {
-		struct desc *d = &descs[desc_cnt++];
-		ASSERT (desc_cnt <= sizeof descs / sizeof *descs);
-		d->block_size = block_size;
-		d->blocks_per_arena = (PGSIZE - sizeof (struct arena)) / block_size;
-		list_init (&d->free_list);
-		lock_init (&d->lock);
+	size_t i, n;
+
+	ASSERT (sizeof (struct slab) % 16 == 0);
+
+	list_init (&all_caches);
+	for (i = n = 0; i < CLASS_CNT; i++) {
+		cache_init (&class_caches[i], "malloc", class_sizes[i], NULL);
+		for (; n <= class_sizes[i] / 16; n++)
+			class_index[n] = i;
+	}
+}
+
+/* Creates and returns a cache of objects of SIZE bytes, named
+   NAME.  If CTOR is nonnull, it is applied to each object once
+   when the object is first created, and objects must be freed
+   in the state it leaves them.  Returns a null pointer if
+   memory is not available. */
+struct kmem_cache *
+kmem_cache_create (const char *name, size_t size, void (*ctor) (void *)) {
+	struct kmem_cache *c;
+
+	ASSERT (size > 0 && size <= CLASS_MAX);
+
+	c = malloc (sizeof *c);
+	if (c != NULL)
+		cache_init (c, name, ROUND_UP (size, 16), ctor);
+	return c;
+}
+
+/* Obtains and returns an object from cache C.  Returns a null
+   pointer if memory is not available. */
+void *
+kmem_cache_alloc (struct kmem_cache *c) {
+	enum intr_level old_level;
+	void *obj;
+
+	old_level = intr_disable ();
+	for (;;) {
+		struct kmem_cpu *kc = &c->cpus[this_cpu ()->id];
+
+		if (kc->loaded->rounds == 0 && kc->prev->rounds > 0) {
+			struct magazine *m = kc->loaded;
+			kc->loaded = kc->prev;
+			kc->prev = m;
+		}
+		if (kc->loaded->rounds > 0) {
+			obj = kc->loaded->objs[--kc->loaded->rounds];
+			kc->allocs++;
+			break;
+		}
+
+		/* Both magazines are empty: refill the loaded one from
+		   the slabs, first adding a slab if need be. */
+		spinlock_acquire (&c->lock);
+		kc->loaded->rounds = slabs_take (c, kc->loaded->objs, c->mag_size);
+		spinlock_release (&c->lock);
+		if (kc->loaded->rounds > 0)
+			kc->refills++;
+		else {
+			intr_set_level (old_level);
+			if (!cache_grow (c))
+				return NULL;
+			old_level = intr_disable ();
+		}
 	}
+	intr_set_level (old_level);
+	return obj;
+}
+
+/* Frees OBJ, which must have been obtained from cache C. */
+void
+kmem_cache_free (struct kmem_cache *c, void *obj) {
+	enum intr_level old_level;
+	struct kmem_cpu *kc;
+
+	ASSERT (block_to_slab (obj)->cache == c);
+
+#ifndef NDEBUG
+	/* Clear the object to help detect use-after-free bugs,
+	   unless it has to keep its constructed state. */
+	if (c->ctor == NULL)
+		memset (obj, 0xcc, c->size);
+#endif
+
+	old_level = intr_disable ();
+	kc = &c->cpus[this_cpu ()->id];
+	if (kc->loaded->rounds == c->mag_size) {
+		struct magazine *m = kc->prev;
+
+		/* Both magazines are full: flush the previous one back
+		   to the slabs. */
+		if (m->rounds > 0) {
+			spinlock_acquire (&c->lock);
+			slabs_put (c, m->objs, m->rounds);
+			spinlock_release (&c->lock);
+			m->rounds = 0;
+		}
+		kc->prev = kc->loaded;
+		kc->loaded = m;
+	}
+	kc->loaded->objs[kc->loaded->rounds++] = obj;
+	intr_set_level (old_level);
 }
 
 /* Obtains and returns a new block of at least SIZE bytes.
    Returns a null pointer if memory is not available. */
 void *
 malloc (size_t size) {
-	struct desc *d;
-	struct block *b;
-	struct arena *a;
+	struct slab *s;
+	size_t page_cnt;
 
 	/* A null pointer satisfies a request for 0 bytes. */
 	if (size == 0)
 		return NULL;
 
-	/* Find the smallest descriptor that satisfies a SIZE-byte
-	   request. */
-	for (d = descs; d < descs + desc_cnt; d++)
-		if (d->block_size >= size)
-			break;
-	if (d == descs + desc_cnt) {
-		/* SIZE is too big for any descriptor.
-		   Allocate enough pages to hold SIZE plus an arena. */
-		size_t page_cnt = DIV_ROUND_UP (size + sizeof *a, PGSIZE);
-		a = palloc_get_multiple (0, page_cnt);
-		if (a == NULL)
-			return NULL;
-
-		/* Initialize the arena to indicate a big block of PAGE_CNT
-		   pages, and return it. */
-		a->magic = ARENA_MAGIC;
-		a->desc = NULL;
-		a->free_cnt = page_cnt;
-		return a + 1;
-	}
-
-	lock_acquire (&d->lock);
-
-	/* If the free list is empty, create a new arena. */
-	if (list_empty (&d->free_list)) {
-		size_t i;
+	if (size <= CLASS_MAX)
+		return kmem_cache_alloc (&class_caches[class_index[DIV_ROUND_UP (size, 16)]]);
 
-		/* Allocate a page. */
-		a = palloc_get_page (0);
-		if (a == NULL) {
-			lock_release (&d->lock);
-			return NULL;
-		}
-
-		/* Initialize arena and add its blocks to the free list. */
-		a->magic = ARENA_MAGIC;
-		a->desc = d;
-		a->free_cnt = d->blocks_per_arena;
-		for (i = 0; i < d->blocks_per_arena; i++) {
-			struct block *b = arena_to_block (a, i);
-			list_push_back (&d->free_list, &b->free_elem);
-		}
-	}
+	/* SIZE is too big for any size class.
+	   Allocate enough pages to hold SIZE plus a header. */
+	if (size > SIZE_MAX - sizeof *s)
+		return NULL;
+	page_cnt = DIV_ROUND_UP (size + sizeof *s, PGSIZE);
+	s = palloc_get_multiple (0, page_cnt);
+	if (s == NULL && page_cnt > 1)
+		s = vmalloc (page_cnt);
+	if (s == NULL)
+		return NULL;
 
-	/* Get a block from free list and return it. */
-	b = list_entry (list_pop_front (&d->free_list), struct block, free_elem);
-	a = block_to_arena (b);
-	a->free_cnt--;
-	lock_release (&d->lock);
-	return b;
+	/* Initialize the header to indicate a big block of PAGE_CNT
+	   pages, and return it. */
+	s->magic = SLAB_MAGIC;
+	s->cache = NULL;
+	s->free_cnt = page_cnt;
+	return s + 1;
 }
 
 /* Allocates and return A times B bytes initialized to zeroes.
@@ -166,11 +302,10 @@ calloc (size_t a, size_t b) {
 /* Returns the number of bytes allocated for BLOCK. */
 static size_t
 block_size (void *block) {
-	struct block *b = block;
-	struct arena *a = block_to_arena (b);
-	struct desc *d = a->desc;
+	struct slab *s = block_to_slab (block);
+	struct kmem_cache *c = s->cache;
 
-	return d != NULL ? d->block_size : PGSIZE * a->free_cnt - pg_ofs (block);
+	return c != NULL ? c->size : PGSIZE * s->free_cnt - pg_ofs (block);
 }
 
 /* Attempts to resize OLD_BLOCK to NEW_SIZE bytes, possibly
@@ -197,72 +332,198 @@ realloc (void *old_block, size_t new_size) {
 }
 
 /* Frees block P, which must have been previously allocated with
-   malloc(), calloc(), or realloc(). */
+   malloc(), calloc(), or realloc(), or obtained from a cache
+   with kmem_cache_alloc(). */
 void
 free (void *p) {
 	if (p != NULL) {
-		struct block *b = p;
-		struct arena *a = block_to_arena (b);
-		struct desc *d = a->desc;
+		struct slab *s = block_to_slab (p);
 
-		if (d != NULL) {
-			/* It's a normal block.  We handle it here. */
+		if (s->cache != NULL)
+			kmem_cache_free (s->cache, p);
+		else {
+			/* It's a big block.  Free its pages. */
+			if (is_vmalloc_vaddr (s))
+				vfree (s);
+			else
+				palloc_free_multiple (s, s->free_cnt);
+		}
+	}
+}
 
-#ifndef NDEBUG
-			/* Clear the block to help detect use-after-free bugs. */
-			memset (b, 0xcc, d->block_size);
-#endif
+/* Prints statistics for each cache that has been used. */
+void
+malloc_print_stats (void) {
+	struct list_elem *e;
+
+	for (e = list_begin (&all_caches); e != list_end (&all_caches);
+			e = list_next (e)) {
+		struct kmem_cache *c = list_entry (e, struct kmem_cache, elem);
+		long long allocs = 0, refills = 0;
+		size_t i;
+
+		for (i = 0; i < NCPU_MAX; i++) {
+			allocs += c->cpus[i].allocs;
+			refills += c->cpus[i].refills;
+		}
+		if (allocs == 0)
+			continue;
+		printf ("Malloc: %s-%zu: %lld allocs, %lld magazine refills, %zu slabs\n",
+				c->name, c->size, allocs, refills, c->slab_cnt);
+	}
+}
+
+/* Initializes C as a cache of objects of SIZE bytes, a
+   multiple of 16, named NAME, with constructor CTOR. */
+static void
+cache_init (struct kmem_cache *c, const char *name, size_t size,
+		void (*ctor) (void *)) {
+	size_t i;
+
+	ASSERT (size % 16 == 0 && size <= CLASS_MAX);
+
+	c->name = name;
+	c->size = size;
+	c->objs_per_slab = (PGSIZE - sizeof (struct slab)) / size;
+	ASSERT (c->objs_per_slab <= SLAB_MAX_OBJS);
+
+	/* Caching more than a slab's worth per magazine would only
+	   pin more pages for large objects. */
+	c->mag_size = c->objs_per_slab < MAG_ROUNDS ? c->objs_per_slab : MAG_ROUNDS;
+	c->ctor = ctor;
+	for (i = 0; i < NCPU_MAX; i++) {
+		struct kmem_cpu *kc = &c->cpus[i];
+
+		kc->loaded = &kc->mags[0];
+		kc->prev = &kc->mags[1];
+		kc->mags[0].rounds = kc->mags[1].rounds = 0;
+		kc->allocs = kc->refills = 0;
+	}
+	spinlock_init (&c->lock, name);
+	list_init (&c->slabs);
+	c->slab_cnt = c->empty_cnt = 0;
+	list_push_back (&all_caches, &c->elem);
+}
 
-			lock_acquire (&d->lock);
+/* Adds a new slab to C.  Returns false if memory is not
+   available. */
+static bool
+cache_grow (struct kmem_cache *c) {
+	enum intr_level old_level;
+	struct slab *s;
+	size_t i;
+
+	s = palloc_get_page (0);
+	if (s == NULL)
+		return false;
+
+	s->magic = SLAB_MAGIC;
+	s->cache = c;
+	s->free_cnt = c->objs_per_slab;
+	memset (s->free_map, 0, sizeof s->free_map);
+	for (i = 0; i < c->objs_per_slab; i++) {
+		s->free_map[i / 64] |= 1ULL << (i % 64);
+		if (c->ctor != NULL)
+			c->ctor (slab_to_block (s, i));
+	}
 
-			/* Add block to free list. */
-			list_push_front (&d->free_list, &b->free_elem);
+	old_level = intr_disable ();
+	spinlock_acquire (&c->lock);
+	list_push_back (&c->slabs, &s->elem);
+	c->slab_cnt++;
+	c->empty_cnt++;
+	spinlock_release (&c->lock);
+	intr_set_level (old_level);
+	return true;
+}
+
+/* Takes up to CNT free objects from C's slabs into OBJS and
+   returns how many it took.  C's lock must be held. */
+static size_t
+slabs_take (struct kmem_cache *c, void **objs, size_t cnt) {
+	size_t n = 0;
 
-			/* If the arena is now entirely unused, free it. */
-			if (++a->free_cnt >= d->blocks_per_arena) {
-				size_t i;
+	ASSERT (spinlock_held (&c->lock));
 
-				ASSERT (a->free_cnt == d->blocks_per_arena);
-				for (i = 0; i < d->blocks_per_arena; i++) {
-					struct block *b = arena_to_block (a, i);
-					list_remove (&b->free_elem);
-				}
-				palloc_free_page (a);
+	while (n < cnt && !list_empty (&c->slabs)) {
+		struct slab *s = list_entry (list_front (&c->slabs), struct slab, elem);
+		size_t w;
+
+		if (s->free_cnt == c->objs_per_slab)
+			c->empty_cnt--;
+		for (w = 0; n < cnt && s->free_cnt > 0; w++) {
+			uint64_t *map = &s->free_map[w];
+
+			ASSERT (w < SLAB_MAX_OBJS / 64);
+			while (n < cnt && *map != 0) {
+				int bit = __builtin_ctzll (*map);
+
+				*map &= *map - 1;
+				objs[n++] = slab_to_block (s, w * 64 + bit);
+				s->free_cnt--;
 			}
+		}
+		if (s->free_cnt == 0)
+			list_remove (&s->elem);
+	}
+	return n;
+}
 
-			lock_release (&d->lock);
-		} else {
-			/* It's a big block.  Free its pages. */
-			palloc_free_multiple (a, a->free_cnt);
-			return;
+/* Returns the CNT objects in OBJS to their slabs in C.  Slabs
+   left with no object in use beyond SLAB_EMPTY_MAX go back to
+   the page allocator.  C's lock must be held. */
+static void
+slabs_put (struct kmem_cache *c, void **objs, size_t cnt) {
+	size_t i;
+
+	ASSERT (spinlock_held (&c->lock));
+
+	for (i = 0; i < cnt; i++) {
+		struct slab *s = block_to_slab (objs[i]);
+		size_t idx = (pg_ofs (objs[i]) - sizeof *s) / c->size;
+
+		ASSERT (!(s->free_map[idx / 64] & (1ULL << (idx % 64))));
+		s->free_map[idx / 64] |= 1ULL << (idx % 64);
+
+		/* Slabs coming off the full state go to the front, so
+		   allocation keeps filling in mostly used slabs. */
+		if (s->free_cnt++ == 0)
+			list_push_front (&c->slabs, &s->elem);
+		if (s->free_cnt == c->objs_per_slab) {
+			if (c->empty_cnt < SLAB_EMPTY_MAX)
+				c->empty_cnt++;
+			else {
+				list_remove (&s->elem);
+				c->slab_cnt--;
+				palloc_free_page (s);
+			}
 		}
 	}
 }
-
-/* Returns the arena that block B is inside. */
-static struct arena *
-block_to_arena (struct block *b) {
-	struct arena *a = pg_round_down (b);
-
-	/* Check that the arena is valid. */
-	ASSERT (a != NULL);
-	ASSERT (a->magic == ARENA_MAGIC);
-
-	/* Check that the block is properly aligned for the arena. */
-	ASSERT (a->desc == NULL
-			|| (pg_ofs (b) - sizeof *a) % a->desc->block_size == 0);
-	ASSERT (a->desc != NULL || pg_ofs (b) == sizeof *a);
-
-	return a;
+
+/* Returns the slab that block B is inside. */
+static struct slab *
+block_to_slab (void *b) {
+	struct slab *s = pg_round_down (b);
+
+	/* Check that the slab is valid. */
+	ASSERT (s != NULL);
+	ASSERT (s->magic == SLAB_MAGIC);
+
+	/* Check that the block is properly aligned for the slab. */
+	ASSERT (s->cache == NULL
+			|| (pg_ofs (b) >= sizeof *s
+				&& (pg_ofs (b) - sizeof *s) % s->cache->size == 0));
+	ASSERT (s->cache != NULL || pg_ofs (b) == sizeof *s);
+
+	return s;
 }
 
-/* Returns the (IDX - 1)'th block within arena A. */
-static struct block *
-arena_to_block (struct arena *a, size_t idx) {
-	ASSERT (a != NULL);
-	ASSERT (a->magic == ARENA_MAGIC);
-	ASSERT (idx < a->desc->blocks_per_arena);
-	return (struct block *) ((uint8_t *) a
-			+ sizeof *a
-			+ idx * a->desc->block_size);
+/* Returns the IDX'th block within slab S. */
+static void *
+slab_to_block (struct slab *s, size_t idx) {
+	ASSERT (s != NULL);
+	ASSERT (s->magic == SLAB_MAGIC);
+	ASSERT (idx < s->cache->objs_per_slab);
+	return (uint8_t *) s + sizeof *s + idx * s->cache->size;
 }
@@ -2,12 +2,14 @@
 #include <bitmap.h>
 #include <debug.h>
 #include <inttypes.h>
+#include <list.h>
 #include <round.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "threads/init.h"
+#include "threads/interrupt.h"
 #include "threads/loader.h"
 #include "threads/synch.h"
 #include "threads/vaddr.h"
@@ -24,13 +26,58 @@
 
    By default, half of system RAM is given to the kernel pool and
    half to the user pool.  That should be huge overkill for the
-   kernel pool, but that's just fine for demonstration purposes. */
+   kernel pool, but that's just fine for demonstration purposes.
+
+   Each pool is a binary buddy allocator.  Its free pages form
+   blocks of 2**K pages, aligned to 2**K pages from the pool's
+   base, kept on one free list per order K.  An allocation takes
+   a block from the smallest nonempty order that fits, splitting
+   it down as needed, and gives back the tail of the block beyond
+   the pages requested.  A free merges each block with its buddy
+   for as long as the buddy is free too.  A free list threads
+   through the first page of each of its blocks, so the only
+   other memory used is one byte per page recording which free
+   block, if any, starts there.
+
+   Each pool also keeps a few pages zeroed ahead of time, which
+   single-page PAL_ZERO requests take without paying for the
+   memset.  The idle thread zeroes them through palloc_prezero()
+   when the CPU has nothing better to do.  As far as the buddy
+   allocator is concerned they are in use; a request that cannot
+   otherwise be met gives them back first. */
+
+/* Largest block order.  Larger requests fail. */
+#define BUDDY_MAX_ORDER 18
+
+/* Order map entry of a page that does not start a free block. */
+#define BUDDY_NONE 0xff
+
+/* Most pre-zeroed pages kept per pool. */
+#define ZERO_POOL_MAX 64
 
 /* A memory pool. */
 struct pool {
-	struct lock lock;               /* Mutual exclusion. */
+	struct spinlock lock;           /* Mutual exclusion. */
 	struct bitmap *used_map;        /* Bitmap of free pages. */
 	uint8_t *base;                  /* Base of pool. */
+	size_t page_cnt;                /* Number of pages in pool. */
+	size_t free_cnt;                /* Number of free pages. */
+
+	/* Buddy allocator. */
+	uint8_t *order_map;             /* Per page: order of the free block
+	                                   starting there, or BUDDY_NONE. */
+	struct list free_lists[BUDDY_MAX_ORDER + 1];
+	size_t block_cnt[BUDDY_MAX_ORDER + 1]; /* Blocks in each free list. */
+	uint32_t nonempty;              /* Bit K set iff free_lists[K] is
+	                                   nonempty. */
+
+	/* Pre-zeroed pages, linked through their first bytes. */
+	struct list zeroed;
+	size_t zero_cnt;                /* Number of pages in ZEROED. */
+	size_t zero_max;                /* Most pages kept in ZEROED. */
+	long long zero_hits;            /* PAL_ZERO pages served from ZEROED. */
+	long long zero_misses;          /* PAL_ZERO pages zeroed on demand. */
+	long long zero_fills;           /* Pages zeroed by palloc_prezero(). */
 };
 
 /* Two pools: one for kernel data, one for user pages. */
@@ -42,6 +89,10 @@ static void
 init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end);
 
 static bool page_from_pool (const struct pool *, void *page);
+static size_t buddy_alloc (struct pool *, int order);
+static void pool_release (struct pool *, size_t page_idx, size_t page_cnt);
+static void *pool_take (struct pool *, size_t page_cnt);
+static bool pool_prezero (struct pool *);
 
 /* multiboot info */
 struct multiboot_info {
@@ -223,12 +274,12 @@ split:
 			page_idx = pg_no (start) - pg_no (pool->base);
 			if ((uint64_t) pool_end < end) {
 				page_cnt = ((uint64_t) pool_end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				pool_release (pool, page_idx, page_cnt);
 				start = (uint64_t) pool_end;
 				goto split;
 			} else {
 				page_cnt = ((uint64_t) end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				pool_release (pool, page_idx, page_cnt);
 			}
 		}
 	}
@@ -262,19 +313,30 @@ palloc_init (void) {
 void *
 palloc_get_multiple (enum palloc_flags flags, size_t page_cnt) {
 	struct pool *pool = flags & PAL_USER ? &user_pool : &kernel_pool;
-
-	lock_acquire (&pool->lock);
-	size_t page_idx = bitmap_scan_and_flip (pool->used_map, 0, page_cnt, false);
-	lock_release (&pool->lock);
-	void *pages;
-
-	if (page_idx != BITMAP_ERROR)
-		pages = pool->base + PGSIZE * page_idx;
-	else
-		pages = NULL;
+	enum intr_level old_level;
+	bool zeroed = false;
+	void *pages = NULL;
+
+	old_level = intr_disable ();
+	spinlock_acquire (&pool->lock);
+	if ((flags & PAL_ZERO) && page_cnt == 1) {
+		if (!list_empty (&pool->zeroed)) {
+			/* Clear only the bytes the link used. */
+			pages = list_pop_front (&pool->zeroed);
+			memset (pages, 0, sizeof (struct list_elem));
+			pool->zero_cnt--;
+			pool->zero_hits++;
+			zeroed = true;
+		} else
+			pool->zero_misses++;
+	}
+	if (pages == NULL)
+		pages = pool_take (pool, page_cnt);
+	spinlock_release (&pool->lock);
+	intr_set_level (old_level);
 
 	if (pages) {
-		if (flags & PAL_ZERO)
+		if ((flags & PAL_ZERO) && !zeroed)
 			memset (pages, 0, PGSIZE * page_cnt);
 	} else {
 		if (flags & PAL_ASSERT)
@@ -296,11 +358,23 @@ palloc_get_page (enum palloc_flags flags) {
 	return palloc_get_multiple (flags, 1);
 }
 
+/* Zeroes one free page ahead of time, for a later single-page
+   PAL_ZERO request to take.  Returns false, having done
+   nothing, if both pools already hold their quota of zeroed
+   pages or are short of free memory.  Called by the idle thread
+   with interrupts on, one page at a time so that it can stop as
+   soon as another thread becomes ready. */
+bool
+palloc_prezero (void) {
+	return pool_prezero (&kernel_pool) || pool_prezero (&user_pool);
+}
+
 /* Frees the PAGE_CNT pages starting at PAGES. */
 void
 palloc_free_multiple (void *pages, size_t page_cnt) {
 	struct pool *pool;
 	size_t page_idx;
+	enum intr_level old_level;
 
 	ASSERT (pg_ofs (pages) == 0);
 	if (pages == NULL || page_cnt == 0)
@@ -318,8 +392,12 @@ palloc_free_multiple (void *pages, size_t page_cnt) {
 #ifndef NDEBUG
 	memset (pages, 0xcc, PGSIZE * page_cnt);
 #endif
+	old_level = intr_disable ();
+	spinlock_acquire (&pool->lock);
 	ASSERT (bitmap_all (pool->used_map, page_idx, page_cnt));
-	bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+	pool_release (pool, page_idx, page_cnt);
+	spinlock_release (&pool->lock);
+	intr_set_level (old_level);
 }
 
 /* Frees the page at PAGE. */
@@ -336,15 +414,238 @@ init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end) {
      and subtract it from the pool's size. */
 	uint64_t pgcnt = (end - start) / PGSIZE;
 	size_t bm_pages = DIV_ROUND_UP (bitmap_buf_size (pgcnt), PGSIZE) * PGSIZE;
+	size_t om_pages = DIV_ROUND_UP (pgcnt, PGSIZE) * PGSIZE;
+	int order;
 
-	lock_init(&p->lock);
+	spinlock_init (&p->lock, p == &kernel_pool ? "kernel pool" : "user pool");
 	p->used_map = bitmap_create_in_buf (pgcnt, *bm_base, bm_pages);
 	p->base = (void *) start;
+	p->page_cnt = pgcnt;
+	p->free_cnt = 0;
 
 	// Mark all to unusable.
 	bitmap_set_all(p->used_map, true);
-
 	*bm_base += bm_pages;
+
+	/* No free blocks yet: populate_pools() releases the usable
+	   pages. */
+	p->order_map = *bm_base;
+	memset (p->order_map, BUDDY_NONE, pgcnt);
+	*bm_base += om_pages;
+	for (order = 0; order <= BUDDY_MAX_ORDER; order++) {
+		list_init (&p->free_lists[order]);
+		p->block_cnt[order] = 0;
+	}
+	p->nonempty = 0;
+
+	list_init (&p->zeroed);
+	p->zero_cnt = 0;
+	p->zero_max = pgcnt / 64 < ZERO_POOL_MAX ? pgcnt / 64 : ZERO_POOL_MAX;
+	p->zero_hits = p->zero_misses = p->zero_fills = 0;
+}
+
+/* Returns the free list element stored in page PAGE_IDX of
+   pool P. */
+static struct list_elem *
+block_elem (struct pool *p, size_t page_idx) {
+	return (struct list_elem *) (p->base + page_idx * PGSIZE);
+}
+
+/* Adds the block of 2**ORDER pages at PAGE_IDX to P's free
+   lists. */
+static void
+block_push (struct pool *p, size_t page_idx, int order) {
+	p->order_map[page_idx] = order;
+	list_push_front (&p->free_lists[order], block_elem (p, page_idx));
+	p->block_cnt[order]++;
+	p->nonempty |= 1u << order;
+}
+
+/* Removes the free block of 2**ORDER pages at PAGE_IDX from P's
+   free lists. */
+static void
+block_remove (struct pool *p, size_t page_idx, int order) {
+	p->order_map[page_idx] = BUDDY_NONE;
+	list_remove (block_elem (p, page_idx));
+	if (--p->block_cnt[order] == 0)
+		p->nonempty &= ~(1u << order);
+}
+
+/* Takes a block of 2**ORDER pages out of P's free lists,
+   splitting a larger one if there is none that size.  Returns
+   the block's first page index, or BITMAP_ERROR if no block is
+   large enough. */
+static size_t
+buddy_alloc (struct pool *p, int order) {
+	uint32_t avail = p->nonempty & ~((1u << order) - 1);
+	struct list_elem *e;
+	size_t page_idx;
+	int o;
+
+	if (avail == 0)
+		return BITMAP_ERROR;
+	o = __builtin_ctz (avail);
+	e = list_front (&p->free_lists[o]);
+	page_idx = ((uint8_t *) e - p->base) / PGSIZE;
+	block_remove (p, page_idx, o);
+
+	/* Keep the front half, free the back half. */
+	while (o > order) {
+		o--;
+		block_push (p, page_idx + ((size_t) 1 << o), o);
+	}
+	return page_idx;
+}
+
+/* Returns the block of 2**ORDER pages at PAGE_IDX to P's free
+   lists, merging it with its buddy for as long as the buddy is
+   a free block of the same order. */
+static void
+buddy_free (struct pool *p, size_t page_idx, int order) {
+	while (order < BUDDY_MAX_ORDER) {
+		size_t buddy = page_idx ^ ((size_t) 1 << order);
+
+		if (buddy + ((size_t) 1 << order) > p->page_cnt
+				|| p->order_map[buddy] != order)
+			break;
+		block_remove (p, buddy, order);
+		page_idx &= ~((size_t) 1 << order);
+		order++;
+	}
+	block_push (p, page_idx, order);
+}
+
+/* Marks the PAGE_CNT pages of P starting at PAGE_IDX as free.
+   The range is cut into the largest aligned blocks that fit,
+   each freed on its own. */
+static void
+pool_release (struct pool *p, size_t page_idx, size_t page_cnt) {
+	bitmap_set_multiple (p->used_map, page_idx, page_cnt, false);
+	p->free_cnt += page_cnt;
+	while (page_cnt > 0) {
+		int order = page_idx != 0 ? __builtin_ctzll (page_idx) : BUDDY_MAX_ORDER;
+
+		if (order > BUDDY_MAX_ORDER)
+			order = BUDDY_MAX_ORDER;
+		while (((size_t) 1 << order) > page_cnt)
+			order--;
+		buddy_free (p, page_idx, order);
+		page_idx += (size_t) 1 << order;
+		page_cnt -= (size_t) 1 << order;
+	}
+}
+
+/* Takes PAGE_CNT contiguous pages out of P's free lists and
+   returns the first, or a null pointer if there is no room.  If
+   P's pre-zeroed pages stand in the way, they are given back to
+   the free lists first.  P's lock must be held. */
+static void *
+pool_take (struct pool *p, size_t page_cnt) {
+	size_t page_idx;
+	int order = 0;
+
+	ASSERT (spinlock_held (&p->lock));
+
+	while (order <= BUDDY_MAX_ORDER && ((size_t) 1 << order) < page_cnt)
+		order++;
+	if (page_cnt == 0 || order > BUDDY_MAX_ORDER)
+		return NULL;
+
+	page_idx = buddy_alloc (p, order);
+	if (page_idx == BITMAP_ERROR && p->zero_cnt > 0) {
+		while (!list_empty (&p->zeroed)) {
+			uint8_t *page = (uint8_t *) list_pop_front (&p->zeroed);
+			pool_release (p, (page - p->base) / PGSIZE, 1);
+		}
+		p->zero_cnt = 0;
+		page_idx = buddy_alloc (p, order);
+	}
+	if (page_idx == BITMAP_ERROR)
+		return NULL;
+
+	/* Give back the part of the block beyond PAGE_CNT. */
+	p->free_cnt -= (size_t) 1 << order;
+	pool_release (p, page_idx + page_cnt, ((size_t) 1 << order) - page_cnt);
+	bitmap_set_multiple (p->used_map, page_idx, page_cnt, true);
+	return p->base + PGSIZE * page_idx;
+}
+
+/* Zeroes a free page of P and adds it to P's pre-zeroed pages,
+   unless P already holds its quota of them or is down to its
+   last few free pages.  Returns true if a page was zeroed. */
+static bool
+pool_prezero (struct pool *p) {
+	enum intr_level old_level;
+	void *page = NULL;
+
+	old_level = intr_disable ();
+	spinlock_acquire (&p->lock);
+	if (p->zero_cnt < p->zero_max && p->free_cnt > p->zero_max)
+		page = pool_take (p, 1);
+	spinlock_release (&p->lock);
+	intr_set_level (old_level);
+	if (page == NULL)
+		return false;
+
+	/* The memset runs with interrupts on and the pool unlocked. */
+	memset (page, 0, PGSIZE);
+
+	old_level = intr_disable ();
+	spinlock_acquire (&p->lock);
+	list_push_front (&p->zeroed, page);
+	p->zero_cnt++;
+	p->zero_fills++;
+	spinlock_release (&p->lock);
+	intr_set_level (old_level);
+	return true;
+}
+
+/* Prints the free space and fragmentation of pool P, named
+   NAME.  Fragmentation is the share of free pages that lie
+   outside the largest free block. */
+static void
+pool_print_stats (struct pool *p, const char *name) {
+	size_t block_cnt[BUDDY_MAX_ORDER + 1];
+	size_t free_cnt, zero_cnt, largest = 0;
+	long long zero_hits, zero_misses, zero_fills;
+	enum intr_level old_level;
+	int order;
+
+	old_level = intr_disable ();
+	spinlock_acquire (&p->lock);
+	memcpy (block_cnt, p->block_cnt, sizeof block_cnt);
+	free_cnt = p->free_cnt;
+	zero_cnt = p->zero_cnt;
+	zero_hits = p->zero_hits;
+	zero_misses = p->zero_misses;
+	zero_fills = p->zero_fills;
+	spinlock_release (&p->lock);
+	intr_set_level (old_level);
+
+	for (order = 0; order <= BUDDY_MAX_ORDER; order++)
+		if (block_cnt[order] > 0)
+			largest = (size_t) 1 << order;
+	printf ("Palloc: %s: %zu of %zu pages free, largest block %zu pages, "
+			"fragmentation %zu%%\n", name, free_cnt, p->page_cnt, largest,
+			free_cnt > 0 ? (free_cnt - largest) * 100 / free_cnt : 0);
+	printf ("  free blocks by order:");
+	for (order = 0; order <= BUDDY_MAX_ORDER; order++)
+		if (block_cnt[order] > 0)
+			printf (" %d:%zu", order, block_cnt[order]);
+	printf ("\n");
+	printf ("  pre-zeroed: %zu pages held, %lld zeroed while idle, "
+			"%lld PAL_ZERO hits, %lld misses (%lld%% hit rate)\n",
+			zero_cnt, zero_fills, zero_hits, zero_misses,
+			zero_hits + zero_misses > 0
+			? zero_hits * 100 / (zero_hits + zero_misses) : 0);
+}
+
+/* Prints free space and fragmentation statistics for both
+   pools. */
+void
+palloc_print_stats (void) {
+	pool_print_stats (&kernel_pool, "kernel pool");
+	pool_print_stats (&user_pool, "user pool");
 }
 
 /* Returns true if PAGE was allocated from POOL,
@@ -0,0 +1,192 @@
+#include "threads/profile.h"
+
+#include <debug.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef FILESYS
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#endif
+
+/* 표본 버퍼의 페이지 수. */
+/* Pages in the sample buffer. */
+#define PROFILE_PAGES 64
+
+/* 종료 시 출력하는 가장 잦은 주소의 수. */
+/* Number of hottest addresses printed at power off. */
+#define PROFILE_TOP 10
+
+int profile_interval;
+
+/* 표본 버퍼. profile_init()이 미리 할당하므로 타이머 인터럽트에서 할당하지 않고
+   채울 수 있습니다. 가득 차면 더 이상 기록하지 않고 버린 수만 셉니다. */
+/* Sample buffer.  Allocated up front by profile_init(), so that
+   the timer interrupt fills it without allocating.  Once full,
+   further samples are only counted as dropped. */
+static struct profile_sample *samples;
+static size_t sample_max;
+static size_t sample_cnt;
+static size_t sample_dropped;
+
+/* 다음 표본까지 남은 틱 수. */
+/* Ticks until the next sample. */
+static int countdown;
+
+static int sample_cmp(const void *, const void *);
+
+/* 프로파일링이 켜져 있으면 표본 버퍼를 할당합니다. palloc_init() 이후에 호출해야 합니다. */
+/* Allocates the sample buffer if profiling is on.  Must be
+   called after palloc_init(). */
+void profile_init(void) {
+    if (profile_interval <= 0)
+        return;
+    samples = palloc_get_multiple(PAL_ASSERT, PROFILE_PAGES);
+    sample_max = PROFILE_PAGES * PGSIZE / sizeof *samples;
+    countdown = profile_interval;
+}
+
+/* 타이머 인터럽트 FRAME이 중단시킨 곳을 표본으로 남깁니다. 커널이 중단되었다면
+   프레임 포인터를 따라 현재 스레드의 커널 스택을 거슬러 올라가며 반환 주소도 남깁니다
+   (커널은 -fno-omit-frame-pointer로 빌드됩니다). */
+/* Takes a sample of where timer interrupt FRAME struck.  If it
+   struck the kernel, also walks the frame pointers up the
+   current thread's kernel stack to record return addresses
+   (the kernel is built with -fno-omit-frame-pointer). */
+void profile_sample(const struct intr_frame *frame) {
+    struct thread *t = thread_current();
+    struct profile_sample *s;
+
+    if (samples == NULL || --countdown > 0)
+        return;
+    countdown = profile_interval;
+    if (sample_cnt >= sample_max) {
+        sample_dropped++;
+        return;
+    }
+
+    s = &samples[sample_cnt++];
+    s->tid = t->tid;
+    s->user = (frame->cs & 3) == 3;
+    s->pad = 0;
+    s->pc[0] = frame->rip;
+    s->depth = 1;
+    if (!s->user) {
+        uint64_t *fp = (uint64_t *)frame->R.rbp;
+
+        /* 프레임은 스레드의 페이지 안에서 바깥쪽으로 갈수록 주소가 커져야 합니다. */
+        /* Frames must lie within the thread's page, each one
+           further out than the last. */
+        while (s->depth < PROFILE_DEPTH && (uint8_t *)fp > (uint8_t *)t &&
+               (uint8_t *)(fp + 2) <= (uint8_t *)t + PGSIZE && ((uintptr_t)fp & 7) == 0 &&
+               fp[1] != 0) {
+            s->pc[s->depth++] = fp[1];
+            if ((uint64_t *)fp[0] <= fp)
+                break;
+            fp = (uint64_t *)fp[0];
+        }
+    }
+}
+
+/* 가장 자주 중단된 주소들을 출력합니다. 함수 이름은 `backtrace' 프로그램으로,
+   호출 스택 전체는 "profile" 작업으로 저장한 파일을 utils/profile로 보면 됩니다. */
+/* Prints the addresses struck most often.  `backtrace' turns
+   them into function names; for whole call stacks, save the
+   profile with the "profile" action and read it with
+   utils/profile. */
+void profile_print_stats(void) {
+    struct profile_sample *buf = samples;
+    struct {
+        uint64_t pc;
+        bool user;
+        size_t cnt;
+    } top[PROFILE_TOP];
+    size_t top_cnt = 0;
+    size_t i, j, run;
+
+    if (buf == NULL)
+        return;
+
+    /* 표본을 그 자리에서 정렬하므로 먼저 기록을 멈춥니다. */
+    /* Sorting happens in place, so stop sampling first. */
+    samples = NULL;
+    printf("Profile: %zu samples, %zu dropped, one every %d ticks\n", sample_cnt, sample_dropped,
+           profile_interval);
+    qsort(buf, sample_cnt, sizeof *buf, sample_cmp);
+
+    for (i = 0; i < sample_cnt; i += run) {
+        for (run = 1; i + run < sample_cnt && !sample_cmp(&buf[i], &buf[i + run]); run++)
+            continue;
+        if (top_cnt == PROFILE_TOP && run <= top[top_cnt - 1].cnt)
+            continue;
+        if (top_cnt < PROFILE_TOP)
+            top_cnt++;
+        for (j = top_cnt - 1; j > 0 && top[j - 1].cnt < run; j--)
+            top[j] = top[j - 1];
+        top[j].pc = buf[i].pc[0];
+        top[j].user = buf[i].user;
+        top[j].cnt = run;
+    }
+    for (i = 0; i < top_cnt; i++)
+        printf("  %#018llx%s: %zu samples (%zu%%)\n", (unsigned long long)top[i].pc,
+               top[i].user ? " (user)" : "", top[i].cnt, top[i].cnt * 100 / sample_cnt);
+}
+
+#ifdef FILESYS
+/* 표본들을 파일 시스템의 ARGV[1] 파일로 저장합니다. "get" 작업으로 스크래치
+   디스크를 통해 호스트로 가져가 utils/profile로 읽을 수 있습니다. */
+/* Saves the samples to file ARGV[1] in the file system, as a
+   struct profile_header followed by the samples.  A following
+   "get" action pulls it to the host through the scratch disk,
+   where utils/profile reads it. */
+void profile_save(char **argv) {
+    const char *file_name = argv[1];
+    struct profile_sample *buf = samples;
+    struct profile_header h;
+    enum intr_level old_level;
+    struct file *f;
+
+    printf("Saving profile to '%s'...\n", file_name);
+    if (buf == NULL)
+        PANIC("%s: profiling is off", file_name);
+
+    /* 파일을 쓰는 동안은 기록을 멈춥니다. */
+    /* Stop sampling while the file is written. */
+    old_level = intr_disable();
+    samples = NULL;
+    intr_set_level(old_level);
+
+    memcpy(h.magic, "PROF", 4);
+    h.sample_size = sizeof *buf;
+    h.sample_cnt = sample_cnt;
+    h.dropped = sample_dropped;
+    h.hz = TIMER_FREQ / profile_interval;
+    h.pad = 0;
+    if (!filesys_create(file_name, sizeof h + (off_t)sample_cnt * sizeof *buf))
+        PANIC("%s: create failed", file_name);
+    f = filesys_open(file_name);
+    if (f == NULL)
+        PANIC("%s: open failed", file_name);
+    file_write(f, &h, sizeof h);
+    file_write(f, buf, sample_cnt * sizeof *buf);
+    file_close(f);
+    samples = buf;
+}
+#endif
+
+/* 두 표본을 중단된 곳으로 비교합니다. */
+/* Orders two samples by where they struck. */
+static int sample_cmp(const void *a_, const void *b_) {
+    const struct profile_sample *a = a_;
+    const struct profile_sample *b = b_;
+
+    if (a->user != b->user)
+        return a->user < b->user ? -1 : 1;
+    return a->pc[0] < b->pc[0] ? -1 : a->pc[0] > b->pc[0];
+}
@@ -0,0 +1,201 @@
+#include "threads/schedtrace.h"
+
+#include <debug.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "devices/timer.h"
+#include "intrinsic.h"
+#include "threads/interrupt.h"
+#include "threads/thread.h"
+#ifdef FILESYS
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#endif
+
+/* 추적 버퍼의 항목 수. 2의 거듭제곱이어야 합니다. */
+/* Number of entries in the trace buffer.  Must be a power of
+   2. */
+#define SCHED_TRACE_SIZE 4096
+
+/* 지연 히스토그램의 칸 수. N번 칸은 [2^N, 2^(N+1)) TSC 사이클을 셉니다. */
+/* Buckets per latency histogram.  Bucket N counts latencies of
+   [2^N, 2^(N+1)) TSC cycles; the last one also takes anything
+   longer. */
+#define SCHED_LAT_BUCKETS 40
+
+bool sched_trace_enabled;
+
+/* 사건 고리 버퍼. 기록하는 쪽은 sched_head를 원자적으로 늘려 칸을 예약하므로
+   락이 필요 없고, 인터럽트 핸들러에서도 기록할 수 있습니다. 가득 차면 가장 오래된 사건을 덮어씁니다. */
+/* Ring buffer of events.  A writer claims a slot by atomically
+   bumping SCHED_HEAD, so recording takes no lock and works from
+   interrupt handlers too.  Once full, the oldest events are
+   overwritten. */
+static struct sched_event sched_ring[SCHED_TRACE_SIZE];
+static uint64_t sched_head;
+
+/* 우선순위별 실행 가능해진 시각부터 실행되기까지의 지연 히스토그램. */
+/* Per-priority histograms of the latency from becoming runnable
+   to running. */
+static uint32_t sched_latency[PRI_MAX + 1][SCHED_LAT_BUCKETS];
+
+/* TSC 주파수를 추정하기 위한 기준점. */
+/* Reference point for estimating the TSC frequency. */
+static uint64_t start_tsc;
+static int64_t start_ticks;
+
+static const char *sched_event_name(uint8_t type);
+static uint64_t tsc_hz(void);
+
+/* 추적의 기준 시각을 잡습니다. 타이머가 동작한 뒤에 호출해야 합니다. */
+/* Sets the reference point of the trace.  Must be called once
+   the timer is running. */
+void sched_trace_init(void) {
+    start_tsc = rdtsc();
+    start_ticks = timer_ticks();
+}
+
+/* T에 대한 TYPE 사건을 기록합니다. OTHER는 관련된 다른 스레드이며 없으면 NULL입니다. */
+/* Records a TYPE event about T.  OTHER is the other thread
+   involved, if any, and PRIORITY the priority to record. */
+void sched_trace_record(enum sched_event_type type, const struct thread *t, const struct thread *other,
+                        int priority) {
+    uint64_t slot = __atomic_fetch_add(&sched_head, 1, __ATOMIC_RELAXED);
+    struct sched_event *e = &sched_ring[slot & (SCHED_TRACE_SIZE - 1)];
+
+    e->tsc = rdtsc();
+    e->tid = t->tid;
+    e->other = other != NULL ? other->tid : 0;
+    e->type = type;
+    e->cpu = this_cpu()->id;
+    e->priority = priority;
+    e->pad = 0;
+}
+
+/* T가 실행 가능해진 시각을 기록합니다. */
+/* Notes that T has just become runnable. */
+void sched_trace_ready(struct thread *t) {
+    if (sched_trace_enabled)
+        t->ready_tsc = rdtsc();
+}
+
+/* 막 실행되기 시작한 NEXT의 대기 지연을 NEXT의 우선순위 히스토그램에 더합니다. */
+/* Adds the time NEXT, just picked to run, spent runnable to the
+   histogram for its priority. */
+void sched_trace_run(const struct thread *next) {
+    uint64_t latency;
+    int bucket;
+
+    if (!sched_trace_enabled || next->ready_tsc == 0)
+        return;
+    latency = rdtsc() - next->ready_tsc;
+    bucket = latency != 0 ? 63 - __builtin_clzll(latency) : 0;
+    if (bucket >= SCHED_LAT_BUCKETS)
+        bucket = SCHED_LAT_BUCKETS - 1;
+    sched_latency[next->priority][bucket]++;
+}
+
+/* 지연 히스토그램과 추적 버퍼 전체를 오래된 순서로 출력합니다. */
+/* Prints the latency histograms and dumps the whole trace
+   buffer, oldest first. */
+void sched_trace_print_stats(void) {
+    uint64_t head = sched_head;
+    uint64_t first = head > SCHED_TRACE_SIZE ? head - SCHED_TRACE_SIZE : 0;
+
+    if (!sched_trace_enabled)
+        return;
+
+    printf("Sched trace: %llu events, %llu dropped, TSC %llu Hz\n", (unsigned long long)head,
+           (unsigned long long)first, (unsigned long long)tsc_hz());
+    for (int pri = PRI_MAX; pri >= PRI_MIN; pri--) {
+        uint64_t total = 0, seen = 0;
+        int median = -1, p99 = -1, max = 0;
+
+        for (int b = 0; b < SCHED_LAT_BUCKETS; b++) {
+            total += sched_latency[pri][b];
+            if (sched_latency[pri][b] != 0)
+                max = b;
+        }
+        if (total == 0)
+            continue;
+        for (int b = 0; b < SCHED_LAT_BUCKETS; b++) {
+            seen += sched_latency[pri][b];
+            if (median < 0 && seen * 2 >= total)
+                median = b;
+            if (p99 < 0 && seen * 100 >= total * 99)
+                p99 = b;
+        }
+        printf("Sched trace: priority %d: %llu runs, latency median < 2^%d, 99%% < 2^%d, max < 2^%d cycles\n", pri,
+               (unsigned long long)total, median + 1, p99 + 1, max + 1);
+    }
+    for (uint64_t i = first; i < head; i++) {
+        const struct sched_event *e = &sched_ring[i & (SCHED_TRACE_SIZE - 1)];
+
+        printf("Sched trace: %llu cpu%d %s %d pri %d -> %d\n", (unsigned long long)e->tsc, e->cpu,
+               sched_event_name(e->type), e->tid, e->priority, e->other);
+    }
+}
+
+#ifdef FILESYS
+/* 추적 버퍼를 파일 시스템의 ARGV[1] 파일로 저장합니다. "get" 작업으로
+   스크래치 디스크를 통해 호스트로 가져갈 수 있습니다. */
+/* Saves the trace buffer to file ARGV[1] in the file system, as
+   a struct sched_trace_header followed by the events, oldest
+   first.  A following "get" action pulls it to the host through
+   the scratch disk. */
+void sched_trace_save(char **argv) {
+    const char *file_name = argv[1];
+    bool enabled = sched_trace_enabled;
+    struct sched_trace_header h;
+    enum intr_level old_level;
+    uint64_t head, first;
+    struct file *f;
+
+    printf("Saving scheduler trace to '%s'...\n", file_name);
+
+    /* 파일을 쓰는 동안 생기는 사건이 버퍼를 덮어쓰지 않도록 기록을 멈춥니다. */
+    /* Stop recording, so that the events caused by writing the
+       file do not overwrite the buffer under us. */
+    old_level = intr_disable();
+    sched_trace_enabled = false;
+    head = sched_head;
+    first = head > SCHED_TRACE_SIZE ? head - SCHED_TRACE_SIZE : 0;
+    memcpy(h.magic, "STRC", 4);
+    h.event_size = sizeof(struct sched_event);
+    h.event_cnt = head - first;
+    h.dropped = first;
+    h.tsc_hz = tsc_hz();
+    intr_set_level(old_level);
+
+    if (!filesys_create(file_name, sizeof h + (off_t)h.event_cnt * sizeof(struct sched_event)))
+        PANIC("%s: create failed", file_name);
+    f = filesys_open(file_name);
+    if (f == NULL)
+        PANIC("%s: open failed", file_name);
+    file_write(f, &h, sizeof h);
+    for (uint64_t i = first; i < head; i++)
+        file_write(f, &sched_ring[i & (SCHED_TRACE_SIZE - 1)], sizeof(struct sched_event));
+    file_close(f);
+    sched_trace_enabled = enabled;
+}
+#endif
+
+/* 사건 종류 TYPE의 이름을 반환합니다. */
+/* Returns the name of event type TYPE. */
+static const char *sched_event_name(uint8_t type) {
+    static const char *names[] = {"switch", "wakeup", "block", "yield", "donate"};
+
+    return type < sizeof names / sizeof *names ? names[type] : "?";
+}
+
+/* sched_trace_init() 이후 흐른 시간으로 TSC 주파수를 추정합니다. */
+/* Estimates the TSC frequency from the time elapsed since
+   sched_trace_init(). */
+static uint64_t tsc_hz(void) {
+    int64_t ticks = timer_elapsed(start_ticks);
+
+    if (ticks <= 0)
+        return 0;
+    return (rdtsc() - start_tsc) / ticks * TIMER_FREQ;
+}
@@ -48,8 +48,15 @@
 #include <stdio.h>
 #include <string.h>
 #include "threads/interrupt.h"
+#include "threads/schedtrace.h"
+#ifdef LOCK_PROFILE
+#include "intrinsic.h"
+#include "threads/lockprof.h"
+#endif
 #include "threads/thread.h"
 
+static void guard_init (struct spinlock *, const char *name);
+
 /* 세마포어 SEMA를 VALUE로 초기화합니다. 세마포어는 두 가지 원자 연산을 가진
 	 음이 아닌 정수입니다. 이 연산자들은 다음과 같습니다:
 
@@ -70,13 +77,14 @@
 
    - up or "V": increment the value (and wake up one waiting
    thread, if any). */
-struct lock filesys_lock;
+struct rwlock filesys_lock;
 
 void sema_init(struct semaphore *sema, unsigned value) {
     ASSERT(sema != NULL);
 
 	sema->value = value;
-	list_init (&sema->waiters);
+	wait_queue_init (&sema->waiters, &sema->guard);
+	guard_init (&sema->guard, "sema");
 }
 
 /* 세마포어에 대한 Down 또는 "P" 연산입니다. SEMA의 값이 양수가 될 때까지 기다린 다음 원자적으로 값을 감소시킵니다.
@@ -108,12 +116,14 @@ sema_down (struct semaphore *sema) {
 	ASSERT (!intr_context ());
 
 	old_level = intr_disable ();
+	spinlock_acquire (&sema->guard);
 	while (sema->value == 0) {
-		// list_push_back (&sema->waiters, &thread_current ()->elem);
-		list_insert_desc_ordered (&sema->waiters, &thread_current ()->elem, less_priority, NULL);
-		thread_block ();
+		wait_queue_push (&sema->waiters, thread_current ());
+		thread_block_on (&sema->guard);
+		spinlock_acquire (&sema->guard);
 	}
 	sema->value--;
+	spinlock_release (&sema->guard);
 	intr_set_level (old_level);
 }
 
@@ -134,6 +144,7 @@ sema_try_down (struct semaphore *sema) {
 	ASSERT (sema != NULL);
 
 	old_level = intr_disable ();
+	spinlock_acquire (&sema->guard);
 	if (sema->value > 0)
 	{
 		sema->value--;
@@ -141,6 +152,7 @@ sema_try_down (struct semaphore *sema) {
 	}
 	else
 		success = false;
+	spinlock_release (&sema->guard);
 	intr_set_level (old_level);
 
 	return success;
@@ -161,12 +173,11 @@ sema_up (struct semaphore *sema) {
 	ASSERT (sema != NULL);
 
 	old_level = intr_disable ();
-	if (!list_empty (&sema->waiters)){
-		list_sort (&sema->waiters, more_priority, 0);
-		thread_unblock (list_entry (list_pop_front (&sema->waiters),
-					struct thread, elem));
-	}
+	spinlock_acquire (&sema->guard);
+	if (!wait_queue_empty (&sema->waiters))
+		thread_unblock (wait_queue_pop (&sema->waiters));
 	sema->value++;
+	spinlock_release (&sema->guard);
 	test_max_priority();
 	intr_set_level (old_level);
 
@@ -174,6 +185,89 @@ sema_up (struct semaphore *sema) {
 
 static void sema_test_helper (void *sema_);
 
+/* 스핀락 L을 NAME이라는 이름으로 초기화합니다. */
+/* Initializes spinlock L, named NAME for debugging. */
+void
+spinlock_init (struct spinlock *l, const char *name) {
+	guard_init (l, name);
+#ifdef LOCK_PROFILE
+	l->prof = lock_prof_register (l, "spinlock", name);
+#endif
+}
+
+/* 다른 동기화 기본 요소 안에 든 스핀락 L을 초기화합니다. 세마포어, 조건 변수,
+   읽기-쓰기 락마다 하나씩 있어 수가 많고, 그 기본 요소 자신의 기록이 더 쓸모
+   있으므로 락 프로파일에는 넣지 않습니다. */
+/* Initializes spinlock L, the guard inside another primitive.
+   Unlike spinlock_init(), leaves L out of the lock profile:
+   there is one in every semaphore, condition and rwlock, and
+   the primitive's own record tells more. */
+static void
+guard_init (struct spinlock *l, const char *name) {
+	ASSERT (l != NULL);
+
+	l->locked = 0;
+	l->cpu = NULL;
+	l->name = name;
+#ifdef LOCK_PROFILE
+	l->prof = NULL;
+#endif
+}
+
+/* 스핀락 L을 획득할 때까지 돕니다. 인터럽트가 꺼져 있어야 하며,
+   같은 CPU에서 재귀적으로 잡으면 안 됩니다. 인터럽트를 끄는 것은
+   같은 CPU의 인터럽트 핸들러로부터, 스핀락은 다른 CPU로부터 보호합니다. */
+/* Spins until spinlock L is acquired.  Interrupts must be off,
+   and L must not already be held by this CPU.  Turning
+   interrupts off protects against handlers on this CPU; the lock
+   itself protects against other CPUs. */
+void
+spinlock_acquire (struct spinlock *l) {
+	ASSERT (l != NULL);
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (!spinlock_held (l));
+
+#ifdef LOCK_PROFILE
+	uint64_t start = rdtsc ();
+	bool contended = false;
+#endif
+	while (__atomic_exchange_n (&l->locked, 1, __ATOMIC_ACQUIRE) != 0) {
+#ifdef LOCK_PROFILE
+		contended = true;
+#endif
+		asm volatile ("pause");
+	}
+	l->cpu = this_cpu ();
+#ifdef LOCK_PROFILE
+	l->acquired_tsc = rdtsc ();
+	lock_prof_acquired (l->prof, contended, l->acquired_tsc - start,
+			__builtin_return_address (0));
+#endif
+}
+
+/* 이 CPU가 보유한 스핀락 L을 해제합니다. */
+/* Releases spinlock L, which must be held by this CPU. */
+void
+spinlock_release (struct spinlock *l) {
+	ASSERT (l != NULL);
+	ASSERT (spinlock_held (l));
+
+#ifdef LOCK_PROFILE
+	lock_prof_released (l->prof, rdtsc () - l->acquired_tsc);
+#endif
+	l->cpu = NULL;
+	__atomic_store_n (&l->locked, 0, __ATOMIC_RELEASE);
+}
+
+/* 이 CPU가 스핀락 L을 보유하고 있으면 true를 반환합니다. */
+/* Returns true if this CPU holds spinlock L. */
+bool
+spinlock_held (const struct spinlock *l) {
+	ASSERT (l != NULL);
+
+	return l->locked && l->cpu == this_cpu ();
+}
+
 /* 세마포어의 셀프 테스트를 수행하는 함수입니다. 이 함수는 두 개의 세마포어를 사용하여 두 개의 스레드 간에 "핑퐁" 동작을 수행합니다.
 	 동작 내용을 확인하기 위해 printf() 호출을 삽입할 수 있습니다. */
 /* Self-test for semaphores that makes control "ping-pong"
@@ -219,7 +313,7 @@ sema_test_helper (void *sema_) {
 	 둘째, 세마포어에는 소유자가 없습니다. 즉, 한 스레드가 세마포어를 "down"한 다음 다른 스레드가 이를 "up"할 수 있지만,
 	 잠금의 경우 동일한 스레드가 잠금을 획득하고 해제해야 합니다. 이러한 제한이 불편할 때에는
 	 세마포어 대신에 잠금을 사용해야 함을 나타냅니다. */
-/* Initializes LOCK.  A lock can be held by at most a single
+/* Initializes LOCK, named NAME.  A lock can be held by at most a single
    thread at any given time.  Our locks are not "recursive", that
    is, it is an error for the thread currently holding a lock to
    try to acquire that lock.
@@ -235,11 +329,37 @@ sema_test_helper (void *sema_) {
    onerous, it's a good sign that a semaphore should be used,
    instead of a lock. */
 void
-lock_init (struct lock *lock) {
+lock_init_named (struct lock *lock, const char *name) {
 	ASSERT (lock != NULL);
+	ASSERT (name != NULL);
 
 	lock->holder = NULL;
+	lock->name = name;
 	sema_init (&lock->semaphore, 1);
+	heap_init (&lock->donors, thread_donor_less, NULL);
+#ifdef LOCK_PROFILE
+	lock->prof = lock_prof_register (lock, "lock", name);
+#endif
+}
+
+/* 방금 LOCK을 얻은 현재 스레드를 보유자로 만들고, 남은 대기자들의 기부를 넘겨받습니다. */
+/* Makes the current thread, which has just downed LOCK's
+   semaphore, its holder.  The donations of threads still
+   waiting for LOCK now go to the current thread. */
+static void
+lock_set_holder (struct lock *lock) {
+	struct thread *curr = thread_current ();
+	enum intr_level old_level = intr_disable ();
+
+	lock->holder = curr;
+#ifdef LOCK_PROFILE
+	lock->acquired_tsc = rdtsc ();
+#endif
+	if (!thread_mlfqs) {
+		heap_push (&curr->held_locks, &lock->holder_elem);
+		refresh_priority ();
+	}
+	intr_set_level (old_level);
 }
 
 /* LOCK을 획득하며, 필요한 경우 사용 가능할 때까지 대기합니다. 현재 스레드가 이미 잠금을 보유하고 있으면 안 됩니다.
@@ -260,16 +380,35 @@ lock_acquire (struct lock *lock) {
 	ASSERT (!intr_context ());
 	ASSERT (!lock_held_by_current_thread (lock));
 	struct thread *curr = thread_current();
+	enum intr_level old_level;
+#ifdef LOCK_PROFILE
+	uint64_t start = rdtsc ();
+	bool contended = lock->holder != NULL;
+#endif
 
-	if (lock->holder) {
+	old_level = intr_disable ();
+	if (lock->holder && !thread_mlfqs) {
+		if (lock->holder->priority < curr->priority)
+			sched_trace (SCHED_EV_DONATE, curr, lock->holder, curr->priority);
 		curr->wait_on_lock = lock;
-		list_insert_ordered(&lock->holder->donations, &curr->donation_elem, thread_compare_donate_priority, NULL);
+		heap_push (&lock->donors, &curr->donor_elem);
 		donate_priority();
 	}
-	
-  	sema_down (&lock->semaphore);
-  	curr->wait_on_lock = NULL;
-	lock->holder = curr;
+	intr_set_level (old_level);
+
+	sema_down (&lock->semaphore);
+
+	old_level = intr_disable ();
+	if (curr->wait_on_lock != NULL) {
+		heap_remove (&lock->donors, &curr->donor_elem);
+		curr->wait_on_lock = NULL;
+	}
+	intr_set_level (old_level);
+	lock_set_holder (lock);
+#ifdef LOCK_PROFILE
+	lock_prof_acquired (lock->prof, contended, lock->acquired_tsc - start,
+			__builtin_return_address (0));
+#endif
 }
 
 /* LOCK을 획득하려고 시도하고, 성공하면 true를 실패하면 false를 반환합니다.
@@ -290,8 +429,12 @@ lock_try_acquire (struct lock *lock) {
 	ASSERT (!lock_held_by_current_thread (lock));
 
 	success = sema_try_down (&lock->semaphore);
-	if (success)
-		lock->holder = thread_current ();
+	if (success) {
+		lock_set_holder (lock);
+#ifdef LOCK_PROFILE
+		lock_prof_acquired (lock->prof, false, 0, __builtin_return_address (0));
+#endif
+	}
 	return success;
 }
 
@@ -307,13 +450,22 @@ lock_try_acquire (struct lock *lock) {
    handler. */
 void
 lock_release (struct lock *lock) {
+	enum intr_level old_level;
+
 	ASSERT (lock != NULL);
 	ASSERT (lock_held_by_current_thread (lock));
 
-	remove_with_lock(lock);
-	refresh_priority();
-
+#ifdef LOCK_PROFILE
+	lock_prof_released (lock->prof, rdtsc () - lock->acquired_tsc);
+#endif
+	old_level = intr_disable ();
+	if (!thread_mlfqs) {
+		heap_remove (&thread_current ()->held_locks, &lock->holder_elem);
+		refresh_priority();
+	}
 	lock->holder = NULL;
+	intr_set_level (old_level);
+
 	sema_up (&lock->semaphore);
 }
 
@@ -329,13 +481,6 @@ lock_held_by_current_thread (const struct lock *lock) {
 	return lock->holder == thread_current ();
 }
 
-/* 리스트에 있는 세마포어 하나를 나타내는 구조체입니다. */
-/* One semaphore in a list. */
-struct semaphore_elem {
-	struct list_elem elem;              /* 리스트 요소입니다. *//* List element. */
-	struct semaphore semaphore;         /* 이 세마포어입니다. *//* This semaphore. */
-};
-
 /* 조건 변수 COND를 초기화합니다. 조건 변수는 한 조각의 코드가 조건을 신호하고, 협력하는
    코드가 그 신호를 받아들이고 그에 따라 작업을 수행할 수 있도록 합니다. */
 /* Initializes condition variable COND.  A condition variable
@@ -345,7 +490,8 @@ void
 cond_init (struct condition *cond) {
 	ASSERT (cond != NULL);
 
-	list_init (&cond->waiters);
+	wait_queue_init (&cond->waiters, &cond->guard);
+	guard_init (&cond->guard, "cond");
 }
 
 /* LOCK을 원자적으로 해제하고, 다른 조각의 코드에 의해 COND가 신호되기를 기다립니다. 
@@ -382,21 +528,46 @@ cond_init (struct condition *cond) {
    we need to sleep. */
 void
 cond_wait (struct condition *cond, struct lock *lock) {
-	struct semaphore_elem waiter;
+	struct thread *curr = thread_current ();
+	enum intr_level old_level;
 
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (lock_held_by_current_thread (lock));
 
-	sema_init (&waiter.semaphore, 0);
-	// list_push_back (&cond->waiters, &waiter.elem);
-	list_insert_desc_ordered(&cond->waiters, &waiter.elem, sema_compare_priority, NULL);
+	old_level = intr_disable ();
+	spinlock_acquire (&cond->guard);
+	wait_queue_push (&cond->waiters, curr);
+	spinlock_release (&cond->guard);
+
 	lock_release (lock);
-	sema_down (&waiter.semaphore);
+
+	/* 락을 놓은 사이에 신호를 받았다면 이미 큐에서 빠졌으므로 잠들지 않습니다. */
+	/* We were queued while still holding LOCK, so no signal can
+	   be lost.  If one arrived after LOCK was released, it has
+	   already taken us off the queue and we must not sleep. */
+	spinlock_acquire (&cond->guard);
+	if (curr->wait_queue == &cond->waiters)
+		thread_block_on (&cond->guard);
+	else
+		spinlock_release (&cond->guard);
+	intr_set_level (old_level);
+
 	lock_acquire (lock);
 }
 
+/* cond_wait()에서 큐에서 꺼낸 스레드 T를 깨웁니다. 아직 잠들기 전이라면 그대로 둡니다. */
+/* Wakes T, just taken off a condition's wait queue.  If T has
+   not gone to sleep yet, it will notice that it is no longer
+   queued and not sleep at all.  The condition's guard must be
+   held. */
+static void
+cond_wake (struct thread *t, void *aux UNUSED) {
+	if (t->status == THREAD_BLOCKED)
+		thread_unblock (t);
+}
+
 /* COND에 대기 중인 스레드가 있다면 (LOCK에 의해 보호됨), 이 함수는 그 중 하나에게 신호를 보내 대기를 깨웁니다.
    이 함수를 호출하기 전에 LOCK을 보유해야 합니다.
 
@@ -410,16 +581,20 @@ cond_wait (struct condition *cond, struct lock *lock) {
    interrupt handler. */
 void
 cond_signal (struct condition *cond, struct lock *lock UNUSED) {
+	enum intr_level old_level;
+
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (lock_held_by_current_thread (lock));
 
-	if (!list_empty (&cond->waiters)) {
-		list_sort(&cond->waiters, sema_compare_priority, NULL);
-		sema_up (&list_entry (list_pop_front (&cond->waiters),
-					struct semaphore_elem, elem)->semaphore);
-	}
+	old_level = intr_disable ();
+	spinlock_acquire (&cond->guard);
+	if (!wait_queue_empty (&cond->waiters))
+		cond_wake (wait_queue_pop (&cond->waiters), NULL);
+	spinlock_release (&cond->guard);
+	test_max_priority ();
+	intr_set_level (old_level);
 }
 
 /* COND (LOCK에 의해 보호됨)에 대기 중인 모든 스레드를 깨웁니다.
@@ -433,22 +608,345 @@ cond_signal (struct condition *cond, struct lock *lock UNUSED) {
    make sense to try to signal a condition variable within an
    interrupt handler. */
 void
-cond_broadcast (struct condition *cond, struct lock *lock) {
+cond_broadcast (struct condition *cond, struct lock *lock UNUSED) {
+	enum intr_level old_level;
+
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
+	ASSERT (!intr_context ());
+	ASSERT (lock_held_by_current_thread (lock));
+
+	/* 우선순위 순서와 상관없이 한 번에 모두 깨웁니다. 실행 순서는 준비 큐가 정합니다. */
+	/* Wake everyone in a single pass.  The order does not matter:
+	   the ready queues decide who runs first. */
+	old_level = intr_disable ();
+	spinlock_acquire (&cond->guard);
+	wait_queue_flush (&cond->waiters, cond_wake, NULL);
+	spinlock_release (&cond->guard);
+	test_max_priority ();
+	intr_set_level (old_level);
+}
 
-	while (!list_empty (&cond->waiters))
-		cond_signal (cond, lock);
+/* 읽기-쓰기 락 RW를 초기화합니다.
+
+   대기자는 읽는 쪽과 쓰는 쪽 구분 없이 하나의 대기 큐에 우선순위 순서로, 같은
+   우선순위 사이에서는 도착 순서로 줄을 섭니다. 락이 풀리면 줄의 맨 앞이 쓰는 쪽이면
+   그 하나에게, 읽는 쪽이면 다음 쓰는 쪽 앞까지의 읽는 쪽 모두에게 락을 넘겨줍니다.
+   누군가 기다리는 동안에는 새로 온 읽는 쪽도 줄을 서야 하고, 쓰는 쪽이 줄을 선 뒤에
+   온 스레드는 우선순위와 관계없이 그 뒤에 서므로, 우선순위가 더 높은 읽는 쪽이
+   끊임없이 와도 쓰는 쪽이 굶지 않습니다. */
+/* Initializes reader-writer lock RW.
+
+   Waiting readers and writers share one wait queue, ordered by
+   priority and then by arrival.  When the lock frees up, it is
+   handed to the thread at the head of the queue if that is a
+   writer, or else to every reader up to the next writer.  While
+   anyone waits, newly arriving readers queue up as well instead
+   of joining the current readers.  Once a writer is queued,
+   later arrivals go behind it whatever their priority (see
+   wait_queue_barrier()), so a steady stream of readers, even
+   higher-priority ones, cannot starve a writer.
+
+   Priorities order the queue but are not donated to the
+   holders.  RW is named NAME for debugging. */
+void
+rwlock_init_named (struct rwlock *rw, const char *name) {
+	ASSERT (rw != NULL);
+	ASSERT (name != NULL);
+
+	rw->readers = 0;
+	rw->writer = NULL;
+	wait_queue_init (&rw->waiters, &rw->guard);
+	guard_init (&rw->guard, name);
+#ifdef LOCK_PROFILE
+	rw->prof = lock_prof_register (rw, "rwlock", name);
+#endif
 }
 
-/* 세마포어에서 스레드 꺼내서 우선순위 비교 */
+#ifdef LOCK_PROFILE
+/* 현재 스레드가 RW를 얻었음을 기록합니다. WRITER면 쓰기 위해 얻었고, CONTENDED면
+   START부터 기다렸습니다. RW의 guard를 잡고 있어야 합니다. */
+/* Records that the current thread acquired RW, for writing if
+   WRITER, after waiting since START if CONTENDED.  CALLER is
+   where the acquire function was called from.  RW's guard must
+   be held. */
+static void
+rwlock_prof_acquired (struct rwlock *rw, bool writer, bool contended,
+		uint64_t start, void *caller) {
+	uint64_t now = rdtsc ();
+
+	ASSERT (spinlock_held (&rw->guard));
+
+	if (writer)
+		rw->write_tsc = now;
+	lock_prof_acquired (rw->prof, contended, now - start, caller);
+}
+#endif
+
+/* RW가 비었거나 읽는 쪽만 보유하고 있을 때, 대기 큐의 맨 앞부터 락을 넘겨줄 수 있는
+   스레드들을 깨웁니다. 깨어난 스레드는 이미 락을 보유한 상태입니다. RW의 guard를
+   잡고 있어야 합니다. */
+/* Hands RW to the threads at the head of its wait queue that
+   can hold it now, and wakes them up already holding it.  RW's
+   guard must be held. */
+static void
+rwlock_grant (struct rwlock *rw) {
+	ASSERT (spinlock_held (&rw->guard));
+
+	while (rw->writer == NULL && !wait_queue_empty (&rw->waiters)) {
+		struct thread *t = wait_queue_top (&rw->waiters);
+
+		if (t->rwlock_writer) {
+			if (rw->readers > 0)
+				break;
+			rw->writer = t;
+		} else
+			rw->readers++;
+		thread_unblock (wait_queue_pop (&rw->waiters));
+	}
+}
+
+/* RW를 읽기 위해 획득하며, 필요하면 잠듭니다. 이미 보유 중인 읽는 쪽도 다시 획득하면
+   안 되는데, 그 사이 쓰는 쪽이 기다리기 시작했다면 교착 상태가 되기 때문입니다. */
+/* Acquires RW for reading, sleeping until it is available if
+   necessary.  Readers must not acquire RW recursively: if a
+   writer started waiting in between, they would deadlock. */
+void
+rwlock_acquire_read (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+	ASSERT (!intr_context ());
+
+#ifdef LOCK_PROFILE
+	uint64_t start = rdtsc ();
+#endif
+	old_level = intr_disable ();
+	spinlock_acquire (&rw->guard);
+	if (rw->writer == NULL && wait_queue_empty (&rw->waiters)) {
+		rw->readers++;
+#ifdef LOCK_PROFILE
+		rwlock_prof_acquired (rw, false, false, start, __builtin_return_address (0));
+#endif
+		spinlock_release (&rw->guard);
+	} else {
+		thread_current ()->rwlock_writer = false;
+		wait_queue_push (&rw->waiters, thread_current ());
+		thread_block_on (&rw->guard);
+#ifdef LOCK_PROFILE
+		spinlock_acquire (&rw->guard);
+		rwlock_prof_acquired (rw, false, true, start, __builtin_return_address (0));
+		spinlock_release (&rw->guard);
+#endif
+	}
+	intr_set_level (old_level);
+}
+
+/* 읽기 위해 보유하던 RW를 놓습니다. */
+/* Releases RW, held for reading. */
+void
+rwlock_release_read (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+
+	old_level = intr_disable ();
+	spinlock_acquire (&rw->guard);
+	ASSERT (rw->readers > 0);
+	if (--rw->readers == 0)
+		rwlock_grant (rw);
+	spinlock_release (&rw->guard);
+	test_max_priority ();
+	intr_set_level (old_level);
+}
+
+/* RW를 쓰기 위해 획득하며, 필요하면 잠듭니다. */
+/* Acquires RW for writing, sleeping until it is available if
+   necessary. */
+void
+rwlock_acquire_write (struct rwlock *rw) {
+	struct thread *curr = thread_current ();
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+	ASSERT (!intr_context ());
+	ASSERT (rw->writer != curr);
+
+#ifdef LOCK_PROFILE
+	uint64_t start = rdtsc ();
+#endif
+	old_level = intr_disable ();
+	spinlock_acquire (&rw->guard);
+	if (rw->writer == NULL && rw->readers == 0 && wait_queue_empty (&rw->waiters)) {
+		rw->writer = curr;
+#ifdef LOCK_PROFILE
+		rwlock_prof_acquired (rw, true, false, start, __builtin_return_address (0));
+#endif
+		spinlock_release (&rw->guard);
+	} else {
+		curr->rwlock_writer = true;
+		wait_queue_push (&rw->waiters, curr);
+		wait_queue_barrier (&rw->waiters);
+		thread_block_on (&rw->guard);
+#ifdef LOCK_PROFILE
+		spinlock_acquire (&rw->guard);
+		rwlock_prof_acquired (rw, true, true, start, __builtin_return_address (0));
+		spinlock_release (&rw->guard);
+#endif
+	}
+	intr_set_level (old_level);
+}
+
+/* 현재 스레드가 쓰기 위해 보유하던 RW를 놓습니다. */
+/* Releases RW, which the current thread holds for writing. */
+void
+rwlock_release_write (struct rwlock *rw) {
+	enum intr_level old_level;
+
+	ASSERT (rw != NULL);
+	ASSERT (rw->writer == thread_current ());
+
+	old_level = intr_disable ();
+	spinlock_acquire (&rw->guard);
+#ifdef LOCK_PROFILE
+	lock_prof_released (rw->prof, rdtsc () - rw->write_tsc);
+#endif
+	rw->writer = NULL;
+	rwlock_grant (rw);
+	spinlock_release (&rw->guard);
+	test_max_priority ();
+	intr_set_level (old_level);
+}
+
+/* 대기 큐의 비교 함수입니다. 단계가 앞설수록, 같으면 우선순위가 높을수록, 그것도
+   같으면 먼저 왔을수록 앞섭니다. */
+/* Orders a wait queue by tier, then by priority, then by
+   arrival. */
+static bool
+waiter_less (const struct heap_elem *a_, const struct heap_elem *b_,
+		void *aux UNUSED) {
+	const struct thread *a = heap_entry (a_, struct thread, wait_elem);
+	const struct thread *b = heap_entry (b_, struct thread, wait_elem);
+
+	if (a->wait_tier != b->wait_tier)
+		return a->wait_tier < b->wait_tier;
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+	return a->wait_seq < b->wait_seq;
+}
+
+/* 대기 큐 Q를 GUARD로 보호되는 빈 큐로 초기화합니다. */
+/* Initializes Q as an empty wait queue protected by GUARD. */
+void
+wait_queue_init (struct wait_queue *q, struct spinlock *guard) {
+	ASSERT (q != NULL);
+	ASSERT (guard != NULL);
+
+	heap_init (&q->waiters, waiter_less, NULL);
+	q->guard = guard;
+	q->next_seq = 0;
+	q->tier = 0;
+}
+
+/* T를 Q에 넣습니다. T는 다른 대기 큐에 있으면 안 됩니다. */
+/* Adds T to Q.  T must not be in any wait queue. */
+void
+wait_queue_push (struct wait_queue *q, struct thread *t) {
+	ASSERT (spinlock_held (q->guard));
+	ASSERT (t->wait_queue == NULL);
+
+	t->wait_queue = q;
+	t->wait_seq = q->next_seq++;
+	t->wait_tier = q->tier;
+	heap_push (&q->waiters, &t->wait_elem);
+}
+
+/* 이후에 Q에 들어오는 스레드는 우선순위와 관계없이 지금 Q에 있는 스레드 모두의
+   뒤에 섭니다. */
+/* Makes every thread added to Q from now on queue behind all the
+   threads in Q now, whatever the priorities. */
+void
+wait_queue_barrier (struct wait_queue *q) {
+	ASSERT (spinlock_held (q->guard));
+
+	q->tier++;
+}
+
+/* Q에서 우선순위가 가장 높은 스레드를 꺼내 반환합니다. Q가 비어 있으면 안 됩니다. */
+/* Removes and returns the highest-priority thread in Q, which
+   must not be empty. */
+struct thread *
+wait_queue_pop (struct wait_queue *q) {
+	struct thread *t;
+
+	ASSERT (spinlock_held (q->guard));
+
+	t = heap_entry (heap_pop (&q->waiters), struct thread, wait_elem);
+	t->wait_queue = NULL;
+	return t;
+}
+
+/* Q에서 우선순위가 가장 높은 스레드를 꺼내지 않고 반환합니다. Q가 비어 있으면 안 됩니다. */
+/* Returns the highest-priority thread in Q without removing
+   it.  Q must not be empty. */
+struct thread *
+wait_queue_top (const struct wait_queue *q) {
+	ASSERT (spinlock_held (q->guard));
+
+	return heap_entry (heap_top (&q->waiters), struct thread, wait_elem);
+}
+
+struct flush_aux {
+	wait_queue_func *func;
+	void *aux;
+};
+
+static void
+flush_one (struct heap_elem *e, void *fa_) {
+	struct flush_aux *fa = fa_;
+	struct thread *t = heap_entry (e, struct thread, wait_elem);
+
+	t->wait_queue = NULL;
+	fa->func (t, fa->aux);
+}
+
+/* Q의 모든 스레드를 꺼내며 각각에 FUNC를 호출합니다. 순서는 정해져 있지 않으며 선형 시간에 끝납니다. */
+/* Removes every thread from Q, calling FUNC on each one with
+   AUX, in no particular order.  Takes time linear in the number
+   of waiters, unlike popping them one at a time.  FUNC must not
+   touch any wait queue. */
+void
+wait_queue_flush (struct wait_queue *q, wait_queue_func *func, void *aux) {
+	struct flush_aux fa = { func, aux };
+
+	ASSERT (spinlock_held (q->guard));
+
+	heap_apply (&q->waiters, flush_one, &fa);
+	heap_init (&q->waiters, waiter_less, NULL);
+}
+
+/* Q가 비어 있으면 true를 반환합니다. */
+/* Returns true if no thread is waiting in Q. */
 bool
-sema_compare_priority (struct list_elem *e1, struct list_elem *e2, void *aux) {
-	struct semaphore_elem *e1_sema = list_entry (e1, struct semaphore_elem, elem);
-	struct semaphore_elem *e2_sema = list_entry (e2, struct semaphore_elem, elem);
+wait_queue_empty (const struct wait_queue *q) {
+	return heap_empty (&q->waiters);
+}
+
+/* 우선순위가 바뀐 T를 대기 중인 큐 안에서 다시 배치합니다. T가 대기 중이 아니면 아무것도 하지 않습니다. */
+/* Repositions T within the wait queue it is in, if any, after a
+   change to its priority.  Unlike the other wait queue
+   functions, this takes the queue's guard itself.  Interrupts
+   must be off. */
+void
+wait_queue_update (struct thread *t) {
+	struct wait_queue *q = t->wait_queue;
 
-	struct list *waiter_e1_sema = &(e1_sema->semaphore.waiters);
-	struct list *waiter_e2_sema = &(e2_sema->semaphore.waiters);
+	ASSERT (intr_get_level () == INTR_OFF);
 
-	return list_entry(list_begin (waiter_e1_sema), struct thread, elem)->priority > list_entry (list_begin (waiter_e2_sema), struct thread, elem)->priority;
-}
\ No newline at end of file
+	if (q == NULL)
+		return;
+	spinlock_acquire (q->guard);
+	if (t->wait_queue == q)
+		heap_update (&q->waiters, &t->wait_elem);
+	spinlock_release (q->guard);
+}
@@ -2,15 +2,19 @@
 
 #include <debug.h>
 #include <random.h>
+#include <round.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "devices/timer.h"
 #include "intrinsic.h"
 #include "threads/flags.h"
 #include "threads/interrupt.h"
 #include "threads/intr-stubs.h"
 #include "threads/palloc.h"
+#include "threads/schedtrace.h"
+#include "threads/switch.h"
 #include "threads/synch.h"
 #include "threads/vaddr.h"
 #ifdef USERPROG
@@ -30,20 +34,44 @@
    Do not modify this value. */
 #define THREAD_BASIC 0xd42df210
 
-/* MEMBER */
-#define PRIORITY "priority"
-
-/* THREAD_READY 상태인 프로세스 목록, 즉 실행할 준비는 되었지만 실제로 실행 중이지 않은 프로세스입니다. */
-/* List of processes in THREAD_READY state, that is, processes
-   that are ready to run but not actually running. */
-static struct list ready_list;
-
-static struct list sleep_list;
-static int64_t next_tick_to_awake = NULL;
-
-/* 유휴 스레드. */
-/* Idle thread. */
-static struct thread *idle_thread;
+/* CPU별 상태. THREAD_READY 상태인 프로세스, 즉 실행할 준비는 되었지만
+   실제로 실행 중이지 않은 프로세스는 각 CPU의 실행 큐에 있습니다.
+   AP를 아직 기동하지 않으므로 부트 CPU 하나만 사용합니다. */
+/* Per-CPU state.  Processes in THREAD_READY state, that is,
+   processes that are ready to run but not actually running,
+   sit on their CPU's run queue.  Only the boot CPU is brought
+   up for now. */
+static struct cpu cpus[NCPU_MAX];
+
+/* 유휴 스레드를 포함해 살아 있는 모든 스레드의 목록. */
+/* List of all live threads, including the idle thread. */
+static struct list all_list;
+
+/* 시스템 load average. MLFQS에서만 사용합니다. */
+/* System load average, used only by the MLFQS. */
+static fixed_t load_avg;
+
+/* 1초마다 recent_cpu를 감쇠시키는 일은 틱마다 MLFQS_DECAY_BATCH개씩 나누어 합니다.
+   decay_epoch는 지나간 초의 수이고, 각 스레드는 자신이 마지막으로 감쇠된 초를
+   기억합니다. 아직 차례가 오지 않은 스레드는 살펴볼 때 밀린 감쇠를 decay_hist의
+   계수로 따라잡습니다. */
+/* The once-a-second recent_cpu decay is spread over the ticks
+   that follow, MLFQS_DECAY_BATCH threads per tick.  decay_epoch
+   counts seconds, and each thread records the last one it was
+   decayed for.  A thread looked at before its turn comes first
+   catches up using the factors kept in decay_hist. */
+#define MLFQS_DECAY_BATCH 8
+#define MLFQS_DECAY_HIST 8
+static int64_t decay_epoch;
+static fixed_t decay_hist[MLFQS_DECAY_HIST];
+static struct list_elem *decay_cursor;  /* all_list에서 다음 차례. *//* Next in all_list. */
+static int64_t decay_pass_epoch;        /* 지금 훑기가 시작된 초. *//* Second the current pass began in. */
+
+/* 잠든 스레드들의 최소 힙. 가장 먼저 깨어날 스레드가 항상 맨 위에 있습니다. */
+/* Min-heap of sleeping threads keyed on wakeup_ticks, so the
+   next deadline is always at the top. */
+static struct heap sleep_heap;
+static struct spinlock sleep_lock;      /* sleep_heap을 보호합니다. *//* Protects sleep_heap. */
 
 /* 초기 스레드, init.c의 main()을 실행하는 스레드. */
 /* Initial thread, the thread running init.c:main(). */
@@ -53,20 +81,35 @@ static struct thread *initial_thread;
 /* Lock used by allocate_tid(). */
 static struct lock tid_lock;
 
-/* 스레드 파괴 요청 목록 */
-/* Thread destruction requests */
-static struct list destruction_req;
-
-/* 통계. */
-/* Statistics. */
-static long long idle_ticks; /* 유휴 상태에서 보낸 타이머 틱 수. */       /* # of timer ticks spent idle. */
-static long long kernel_ticks; /* 커널 스레드에서 보낸 타이머 틱 수. */   /* # of timer ticks in kernel threads. */
-static long long user_ticks; /* 사용자 프로그램에서 보낸 타이머 틱 수. */ /* # of timer ticks in user programs. */
+/* 최근 해제된 페이지를 초기화 없이 다시 쓰기 위한 타입별 캐시.
+   페이지 풀 락과 4 kB memset을 거치지 않고 fork가 잦은 작업의 할당을 처리합니다.
+   비어 있는 페이지의 맨 앞에 list_elem을 두고 연결합니다. */
+/* Per-type cache of recently freed pages, reused without going
+   through the page pool lock or a full 4 kB memset.  Free pages
+   are linked through a list_elem stored at their start. */
+struct obj_cache {
+    const char *name;           /* 이름 (통계용). *//* Name (for statistics). */
+    struct spinlock lock;       /* 아래 필드를 보호합니다. *//* Protects the fields below. */
+    struct list pages;          /* 캐시된 페이지. *//* Cached pages. */
+    size_t page_cnt;            /* PAGES의 길이. *//* Length of PAGES. */
+    enum palloc_flags miss_flags; /* 캐시가 비었을 때 palloc 플래그. *//* palloc flags on a miss. */
+    long long hits;             /* 캐시에서 꺼낸 횟수. *//* # of gets served from cache. */
+    long long misses;           /* palloc으로 넘어간 횟수. *//* # of gets that fell back to palloc. */
+};
+
+#define OBJ_CACHE_MAX 32 /* 타입별로 캐시할 최대 페이지 수. */ /* Most pages kept per cache. */
+
+/* 스레드 페이지는 init_thread()가 struct thread만 초기화하므로 0으로 채울 필요가 없습니다.
+   fdt 페이지는 반환될 때 사용한 범위만 지워 두므로 꺼낼 때 다시 지울 필요가 없습니다. */
+/* Thread pages need no zeroing, as init_thread() resets struct
+   thread itself.  Fdt pages are cleaned up to their high-water
+   mark on release, so they come out of the cache already zero. */
+static struct obj_cache thread_cache;
+static struct obj_cache fdt_cache;
 
 /* 스케줄링. */
 /* Scheduling. */
 #define TIME_SLICE 4 /* 각 스레드에게 주어지는 타이머 틱 수. */     /* # of timer ticks to give each thread. */
-static unsigned thread_ticks; /* 마지막 yield 이후 타이머 틱 수. */ /* # of timer ticks since last yield. */
 
 /* false(기본값)면 라운드-로빈 스케줄러를 사용합니다.
    true면 다중 레벨 피드백 큐 스케줄러를 사용합니다.
@@ -76,16 +119,125 @@ static unsigned thread_ticks; /* 마지막 yield 이후 타이머 틱 수. */ /*
    Controlled by kernel command-line option "-o mlfqs". */
 bool thread_mlfqs;
 
+/* true면 가중치 공정 스케줄러를 사용합니다. 커널 명령줄 옵션 "-cfs"에 의해 제어됩니다. */
+/* If true, use the weighted fair scheduler.
+   Controlled by kernel command-line option "-cfs". */
+bool thread_cfs;
+
+/* 가중치 공정 스케줄러 설정. 시간 단위는 타이머 틱입니다. */
+/* Weighted fair scheduler tuning, in timer ticks. */
+#define CFS_LATENCY 8            /* 모든 준비 스레드가 한 번씩 도는 주기. *//* Period in which every ready thread runs once. */
+#define CFS_MIN_GRANULARITY 1    /* 가장 짧은 타임 슬라이스. *//* Shortest time slice. */
+#define CFS_WAKEUP_GRANULARITY 1 /* 깨어난 스레드가 선점하는 데 필요한 vruntime 차이. *//* vruntime lead a waker needs to preempt. */
+
+/* vruntime은 nice 0 스레드가 한 틱 실행할 때 CFS_TICK만큼 늘어납니다. */
+/* A nice-0 thread's vruntime grows by CFS_TICK per tick run. */
+#define CFS_TICK 1024
+#define NICE_0_WEIGHT 1024
+
+/* nice 값마다의 가중치. nice가 1 늘 때마다 CPU 몫이 약 10% 줄도록 1.25배씩 차이 납니다. */
+/* Weight of each nice value, NICE_MIN first.  Neighbors differ
+   by a factor of about 1.25, so each step of nice changes a
+   thread's share of the CPU by roughly 10%. */
+static const int cfs_weights[NICE_MAX - NICE_MIN + 1] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548,  7620,  6100,  4904,  3906,
+    3121,  2501,  1991,  1586,  1277,
+    1024,  820,   655,   526,   423,
+    335,   272,   215,   172,   137,
+    110,   87,    70,    56,    45,
+    36,    29,    23,    18,    15,
+    12,
+};
+
 static void kernel_thread(thread_func *, void *aux);
 
+/* EDF 설정. 허용되는 이용률 합의 상한으로, 나머지는 일반 스레드의 몫입니다. */
+/* EDF tuning.  Admission keeps the total EDF utilization at or
+   below this, in per mille, leaving the rest to normal threads. */
+#define EDF_UTIL_MAX 900
+
+/* CPU 대역폭 그룹. 그룹은 주기 PERIOD마다 QUOTA 틱까지 CPU를 쓸 수 있고,
+   다 쓰면 다음 주기까지 그룹 안의 스레드가 실행 큐에서 빠집니다.
+   그룹은 트리를 이루며, 한 틱은 스레드의 그룹과 모든 조상 그룹에 청구됩니다.
+   모든 필드는 실행 큐 락이 보호합니다. */
+/* CPU bandwidth group.  A group may use up to QUOTA ticks of CPU
+   in each PERIOD; once it has, its threads are parked off the run
+   queue until the next period starts.  Groups form a tree rooted
+   at cpu_groups[0], which is unlimited, and each tick is charged
+   to the running thread's group and all of its ancestors, so a
+   group is held back by the tightest quota on its path to the
+   root.  All fields are protected by the run queue lock. */
+struct cpu_group {
+    int id;                     /* cpu_groups[]의 인덱스. *//* Index in cpu_groups[]. */
+    int ref_cnt;                /* 구성원 스레드, 자식 그룹, 만든 프로세스의 참조 수, 0이면 빈 슬롯. *//* Members, child groups and owner; 0 if free. */
+    struct thread *owner;       /* 그룹을 만든 프로세스의 주 스레드. *//* Main thread of the creating process. */
+    struct cpu_group *parent;   /* 부모 그룹, 루트는 NULL. *//* Parent group, null for the root. */
+    int64_t quota;              /* 주기당 허용 틱, 0이면 무제한. *//* Ticks allowed per period, 0 if unlimited. */
+    int64_t period;             /* 주기. *//* Period. */
+    int64_t runtime;            /* 이번 주기에 쓴 틱. *//* Ticks used in this period. */
+    int64_t period_end;         /* 이번 주기가 끝나는 시각. *//* When this period ends. */
+    bool throttled;             /* 할당량을 다 써서 멈춰 있음. *//* Out of quota until PERIOD_END. */
+    int64_t throttled_since;    /* 멈춘 시각. *//* When it was throttled. */
+    struct list parked;         /* 이 그룹 때문에 멈춘 준비 스레드. *//* Ready threads parked on this group. */
+    struct list_elem throttled_elem; /* throttled_groups의 요소. *//* Element in throttled_groups. */
+
+    /* 통계. */
+    /* Statistics. */
+    long long consumed_ticks;   /* 자손을 포함해 청구된 틱. *//* Ticks charged, descendants included. */
+    long long throttled_ticks;  /* 멈춰 있던 틱. *//* Ticks spent throttled. */
+    long long throttle_cnt;     /* 멈춘 횟수. *//* # of times throttled. */
+};
+
+static struct cpu_group cpu_groups[CPU_GROUP_MAX];
+static struct list throttled_groups;    /* 멈춘 그룹 목록. *//* Throttled groups. */
+
 static void idle(void *aux UNUSED);
 static struct thread *next_thread_to_run(void);
 static void init_thread(struct thread *, const char *name, int priority);
 static void do_schedule(int status);
 static void schedule(void);
 static tid_t allocate_tid(void);
-void thread_sleep(int64_t ticks);
-void thread_wakeup(int64_t ticks);
+static void ready_push(struct thread *);
+static void ready_remove(struct thread *);
+static int ready_max_priority(void);
+static int64_t next_wakeup(void);
+static bool sleep_less(const struct heap_elem *, const struct heap_elem *, void *aux);
+static int lock_priority(const struct lock *);
+static bool held_lock_less(const struct heap_elem *, const struct heap_elem *, void *aux);
+static bool cfs_less(const struct rb_node *, const struct rb_node *, void *aux);
+static int cfs_weight(const struct thread *);
+static void cfs_tick(struct thread *);
+static unsigned cfs_slice(const struct cpu *, const struct thread *);
+static bool cfs_should_preempt(const struct thread *);
+static bool edf_less(const struct heap_elem *, const struct heap_elem *, void *aux);
+static bool edf_active(const struct thread *);
+static int edf_util(const struct thread *);
+static void edf_leave(struct cpu *, struct thread *);
+static bool edf_tick(struct thread *);
+static bool edf_should_preempt(const struct thread *);
+static struct thread *pick_ready(struct cpu *);
+static void cpu_group_get(struct cpu_group *);
+static void cpu_group_put(struct cpu_group *);
+static struct cpu_group *cpu_group_throttled(const struct thread *);
+static bool cpu_group_park(struct thread *);
+static void cpu_group_unthrottle(struct cpu_group *, int64_t now);
+static bool cpu_group_tick(struct thread *);
+static void cpu_group_print_stats(void);
+static bool cpu_group_within(const struct cpu_group *, const struct cpu_group *ancestor);
+static void cpu_group_move(struct thread *, struct cpu_group *);
+static void cpu_group_disown(struct thread *);
+static int mlfqs_priority(const struct thread *);
+static void mlfqs_tick(struct thread *);
+static void mlfqs_decay(struct thread *);
+static void mlfqs_decay_batch(void);
+static void all_list_remove(struct thread *);
+static void rusage_add(struct rusage *, const struct rusage *);
+static void obj_cache_init(struct obj_cache *, const char *name, enum palloc_flags);
+static void *obj_cache_get(struct obj_cache *);
+static void obj_cache_put(struct obj_cache *, void *page);
+static void obj_cache_print_stats(struct obj_cache *);
 
 /* T가 유효한 스레드를 가리키는지 확인합니다. */
 /* Returns true if T appears to point to a valid thread. */
@@ -102,6 +254,14 @@ void thread_wakeup(int64_t ticks);
  * somewhere in the middle, this locates the curent thread. */
 #define running_thread() ((struct thread *)(pg_round_down(rrsp())))
 
+/* 이 코드를 실행 중인 CPU를 반환합니다.
+   AP를 기동하게 되면 LAPIC ID로 cpus[]를 찾아야 합니다. */
+/* Returns the CPU executing this code.  Once the APs are
+   started this must index cpus[] by local APIC ID. */
+struct cpu *this_cpu(void) {
+    return &cpus[0];
+}
+
 // 스레드 시작을 위한 전역 설명자 테이블.
 // 스레드 초기화 후 gdt가 설정되기 때문에, 임시 gdt를 먼저 설정해야 합니다.
 // Global descriptor table for the thread_start.
@@ -147,62 +307,176 @@ void thread_init(void) {
     /* 전역 스레드 컨텍스트 초기화 */
     /* Init the globla thread context */
     lock_init(&tid_lock);
-    list_init(&ready_list);
-    list_init(&sleep_list);
-    list_init(&destruction_req);
+    for (int id = 0; id < NCPU_MAX; id++) {
+        struct cpu *c = &cpus[id];
+
+        c->id = id;
+        spinlock_init(&c->rq_lock, "rq");
+        for (int i = PRI_MIN; i <= PRI_MAX; i++)
+            list_init(&c->ready_queues[i]);
+        c->ready_bitmap = 0;
+        c->ready_cnt = 0;
+        rb_init(&c->cfs_tree, cfs_less, NULL);
+        c->cfs_weight = 0;
+        c->min_vruntime = 0;
+        c->slice = TIME_SLICE;
+        heap_init(&c->edf_queue, edf_less, NULL);
+        heap_init(&c->edf_throttled, edf_less, NULL);
+        c->edf_util = 0;
+        list_init(&c->destruction_req);
+    }
+    list_init(&all_list);
+    decay_cursor = list_end(&all_list);
+    for (int id = 0; id < CPU_GROUP_MAX; id++) {
+        cpu_groups[id].id = id;
+        list_init(&cpu_groups[id].parked);
+    }
+    cpu_groups[0].ref_cnt = 2;          /* 고정 참조와 초기 스레드. *//* Pinned, plus the initial thread. */
+    list_init(&throttled_groups);
+    load_avg = 0;
+    heap_init(&sleep_heap, sleep_less, NULL);
+    spinlock_init(&sleep_lock, "sleep");
+    obj_cache_init(&thread_cache, "thread", 0);
+    obj_cache_init(&fdt_cache, "fdt", PAL_ZERO);
 
     /* 실행 중인 스레드를 위한 스레드 구조체 설정 */
     /* Set up a thread structure for the running thread. */
     initial_thread = running_thread();
     init_thread(initial_thread, "main", PRI_DEFAULT);
+    initial_thread->cpu_group = &cpu_groups[0];
     initial_thread->status = THREAD_RUNNING;
     initial_thread->tid = allocate_tid();
 }
 
-// 스레드를 sleep 시켜서 sleep_list에 넣습니다.
+// 스레드를 TICKS까지 sleep 시켜서 sleep_heap에 넣습니다.
 void thread_sleep(int64_t ticks) {
     struct thread *curr = thread_current();
     enum intr_level old_level;
 
     old_level = intr_disable();
 
-    if (curr != idle_thread) {
+    if (curr != this_cpu()->idle_thread) {
+        spinlock_acquire(&sleep_lock);
         curr->wakeup_ticks = ticks;
-        list_push_front(&sleep_list, &curr->elem);
-        next_awake_ticks(curr->wakeup_ticks);
-        thread_block();
+        heap_push(&sleep_heap, &curr->sleep_elem);
+        thread_block_on(&sleep_lock);
     }
 
     intr_set_level(old_level);
 }
 
-// 깨어날 thread wakeup_ticks 중에서 작거나 같은 것을 wakeup_ticks를 업데이트
-void next_awake_ticks(int64_t ticks) {
-    if (next_tick_to_awake == NULL)
-        next_tick_to_awake = ticks;
-    if (ticks < next_tick_to_awake)
-        next_tick_to_awake = ticks;
+// thread_block_on(GUARD)처럼 잠들되, 타이머가 TICKS에 이르면 스스로 깨어납니다.
+// 그 전에 깨우려면 GUARD를 잡고 thread_wake_sleeper()를 호출합니다.
+// 락 순서는 GUARD, sleep_lock, 실행 큐 락입니다.
+/* Like thread_block_on(GUARD), but the timer also wakes us up
+   once it reaches tick TICKS.  To wake us up earlier, call
+   thread_wake_sleeper() while holding GUARD.  Locks are taken
+   in the order GUARD, sleep_lock, run queue lock. */
+void thread_sleep_on(struct spinlock *guard, int64_t ticks) {
+    struct thread *curr = thread_current();
+
+    ASSERT(!intr_context());
+    ASSERT(intr_get_level() == INTR_OFF);
+    ASSERT(spinlock_held(guard));
+
+    spinlock_acquire(&sleep_lock);
+    curr->wakeup_ticks = ticks;
+    heap_push(&sleep_heap, &curr->sleep_elem);
+    spinlock_acquire(&this_cpu()->rq_lock);
+    curr->status = THREAD_BLOCKED;
+    spinlock_release(&sleep_lock);
+    spinlock_release(guard);
+    schedule();
 }
 
-// 일어날 시간이 되면 대기 큐에 업데이트 후 sleep_list에서 remove
-void thread_wakeup(int64_t ticks) {
-    struct list_elem *e = list_begin(&sleep_list);  // sleep_list 시작부터 순회
-    
-    if (ticks < next_tick_to_awake)
-        return;
+// thread_sleep_on()으로 잠든 T를 깨웁니다. T가 잠들 때 넘긴 GUARD를 잡고 있어야 합니다.
+// 타이머가 이미 깨웠다면 아무것도 하지 않습니다.
+/* Wakes up T, asleep in thread_sleep_on(), unless the timer has
+   already done so.  The caller must hold the GUARD that T passed
+   to thread_sleep_on(), so that T cannot have gone back to
+   sleep since. */
+void thread_wake_sleeper(struct thread *t) {
+    ASSERT(intr_get_level() == INTR_OFF);
 
-    while (e != list_end(&sleep_list))  // sleep_list에 마지막까지 봄
-    {
-        struct thread *t = list_entry(e, struct thread, elem);
+    /* 잠든 동안은 sleep_heap에 있으며, 타이머가 꺼내면 곧바로 깨웁니다.
+       그러므로 sleep_lock 아래에서 BLOCKED이면 아직 힙에 있습니다. */
+    /* While asleep, T is in sleep_heap, and the timer wakes T as
+       soon as it takes T out.  So under sleep_lock, T is still in
+       the heap exactly if it is still blocked. */
+    spinlock_acquire(&sleep_lock);
+    if (t->status == THREAD_BLOCKED) {
+        heap_remove(&sleep_heap, &t->sleep_elem);
+        thread_unblock(t);
+    }
+    spinlock_release(&sleep_lock);
+}
 
-        if (t->wakeup_ticks <= ticks) {
-            e = list_remove(e);
-            thread_unblock(t);
-        }
-        else {
-            e = list_next(e);
-        }
+// 타이머 틱이 할 일이 생기는 가장 이른 시각을 반환합니다. 잠든 스레드가 깨어날 때,
+// 예산을 다 쓴 EDF 스레드의 마감, 멈춘 그룹의 주기가 끝날 때 중 가장 이른 것이며,
+// 아무것도 없으면 INT64_MAX입니다.
+/* Returns the earliest tick at which the timer has work to do:
+   the first sleeper's wakeup, the deadline of the first EDF
+   thread waiting out its budget, or the end of a throttled
+   group's period.  INT64_MAX if there is none. */
+int64_t thread_next_event(void) {
+    struct cpu *c = this_cpu();
+    enum intr_level old_level = intr_disable();
+    struct heap_elem *top;
+    struct list_elem *e;
+    int64_t next;
+
+    spinlock_acquire(&sleep_lock);
+    next = next_wakeup();
+    spinlock_release(&sleep_lock);
+
+    spinlock_acquire(&c->rq_lock);
+    top = heap_top(&c->edf_throttled);
+    if (top != NULL && heap_entry(top, struct thread, edf_elem)->edf_deadline < next)
+        next = heap_entry(top, struct thread, edf_elem)->edf_deadline;
+    for (e = list_begin(&throttled_groups); e != list_end(&throttled_groups); e = list_next(e)) {
+        struct cpu_group *g = list_entry(e, struct cpu_group, throttled_elem);
+
+        if (g->period_end < next)
+            next = g->period_end;
     }
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return next;
+}
+
+// 일어날 시간이 된 스레드만 sleep_heap에서 꺼내 준비 큐에 넣습니다.
+// 깨어날 스레드가 없으면 힙의 맨 위만 보고 바로 반환합니다.
+void thread_wakeup(int64_t ticks) {
+    enum intr_level old_level = intr_disable();
+
+    spinlock_acquire(&sleep_lock);
+    while (next_wakeup() <= ticks) {
+        struct thread *t = heap_entry(heap_pop(&sleep_heap), struct thread, sleep_elem);
+        thread_unblock(t);
+    }
+    spinlock_release(&sleep_lock);
+
+    /* 다음 주기를 기다리던 EDF 스레드는 타임 슬라이스가 끝나기를 기다리지 않습니다. */
+    /* An EDF thread released for its next period does not wait
+       for the time slice to run out. */
+    if (intr_context() && edf_should_preempt(thread_current()))
+        intr_yield_on_return();
+    intr_set_level(old_level);
+}
+
+// sleep_lock을 잡은 상태에서 가장 이른 wakeup_ticks를 반환합니다.
+static int64_t next_wakeup(void) {
+    struct heap_elem *top = heap_top(&sleep_heap);
+
+    ASSERT(spinlock_held(&sleep_lock));
+    if (top == NULL)
+        return INT64_MAX;
+    return heap_entry(top, struct thread, sleep_elem)->wakeup_ticks;
+}
+
+// wakeup_ticks가 더 이른 스레드가 힙의 위로 올라갑니다.
+static bool sleep_less(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED) {
+    return heap_entry(a, struct thread, sleep_elem)->wakeup_ticks < heap_entry(b, struct thread, sleep_elem)->wakeup_ticks;
 }
 
 /* 선점형 스레드 스케줄링을 시작하기 위해 인터럽트를 활성화합니다.
@@ -226,33 +500,56 @@ void thread_start(void) {
 }
 
 /* 타이머 인터럽트 핸들러가 각 타이머 틱마다 호출합니다.
-   따라서, 이 함수는 외부 인터럽트 컨텍스트에서 실행됩니다. */
+   따라서, 이 함수는 외부 인터럽트 컨텍스트에서 실행됩니다.
+   USER는 인터럽트가 사용자 모드에서 걸렸는지를 나타냅니다. */
 /* Called by the timer interrupt handler at each timer tick.
-   Thus, this function runs in an external interrupt context. */
-void thread_tick(void) {
+   Thus, this function runs in an external interrupt context.
+   USER tells whether the interrupt arrived in user mode. */
+void thread_tick(bool user) {
+    struct cpu *c = this_cpu();
     struct thread *t = thread_current();
 
     /* 통계 업데이트 */
     /* Update statistics. */
-    if (t == idle_thread)
-        idle_ticks++;
-#ifdef USERPROG
-    else if (t->pml4 != NULL)
-        user_ticks++;
-#endif
-    else
-        kernel_ticks++;
+    if (t == c->idle_thread)
+        c->idle_ticks++;
+    else if (user) {
+        c->user_ticks++;
+        t->rusage.utime++;
+    } else {
+        c->kernel_ticks++;
+        t->rusage.stime++;
+    }
+
+    if (thread_mlfqs)
+        mlfqs_tick(t);
+    else if (thread_cfs)
+        cfs_tick(t);
+    if (edf_tick(t))
+        intr_yield_on_return();
+    if (cpu_group_tick(t))
+        intr_yield_on_return();
 
     /* 선점 강제 실행 */
     /* Enforce preemption. */
-    if (++thread_ticks >= TIME_SLICE)
+    if (++c->thread_ticks >= (thread_cfs ? c->slice : TIME_SLICE))
         intr_yield_on_return();
 }
 
 /* 스레드 통계를 출력합니다. */
 /* Prints thread statistics. */
 void thread_print_stats(void) {
+    long long idle_ticks = 0, kernel_ticks = 0, user_ticks = 0;
+
+    for (int id = 0; id < NCPU_MAX; id++) {
+        idle_ticks += cpus[id].idle_ticks;
+        kernel_ticks += cpus[id].kernel_ticks;
+        user_ticks += cpus[id].user_ticks;
+    }
     printf("Thread: %lld idle ticks, %lld kernel ticks, %lld user ticks\n", idle_ticks, kernel_ticks, user_ticks);
+    obj_cache_print_stats(&thread_cache);
+    obj_cache_print_stats(&fdt_cache);
+    cpu_group_print_stats();
 }
 
 /* NAME이라는 이름의 새 커널 스레드를 생성하고 주어진 초기
@@ -285,6 +582,7 @@ void thread_print_stats(void) {
    PRIORITY, but no actual priority scheduling is implemented.
    Priority scheduling is the goal of Problem 1-3. */
 tid_t thread_create(const char *name, int priority, thread_func *function, void *aux) {
+    enum intr_level old_level;
     struct thread *t;
     tid_t tid;
 
@@ -292,17 +590,39 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
 
     /* 스레드 할당. */
     /* Allocate thread. */
-    t = palloc_get_page(PAL_ZERO);
-    if (t == NULL) {
-        palloc_free_page(t);
+    t = obj_cache_get(&thread_cache);
+    if (t == NULL)
         return TID_ERROR;
-    }
 
     /* 스레드 초기화. */
     /* Initialize thread. */
     init_thread(t, name, priority);
     tid = t->tid = allocate_tid();
 
+    // mlfqs: nice와 recent_cpu는 부모로부터 물려받고, 우선순위는 그로부터 계산합니다.
+    if (thread_mlfqs) {
+        old_level = intr_disable();
+        mlfqs_decay(thread_current());
+        intr_set_level(old_level);
+        t->nice = thread_current()->nice;
+        t->recent_cpu = thread_current()->recent_cpu;
+        t->priority = t->init_priority = mlfqs_priority(t);
+    }
+
+    // 대역폭 그룹은 부모로부터 물려받습니다. process_fork()의 자식도 여기서 부모의 그룹에 들어갑니다.
+    old_level = intr_disable();
+    spinlock_acquire(&this_cpu()->rq_lock);
+    t->cpu_group = thread_current()->cpu_group;
+    cpu_group_get(t->cpu_group);
+    spinlock_release(&this_cpu()->rq_lock);
+    intr_set_level(old_level);
+
+    // cfs: nice를 물려받고, 지금까지 밀린 만큼 앞서지 않도록 min_vruntime에서 시작합니다.
+    if (thread_cfs) {
+        t->nice = thread_current()->nice;
+        t->vruntime = this_cpu()->min_vruntime;
+    }
+
     /* kernel_thread 호출 시 스케줄링됩니다.
      * 주의) rdi는 첫 번째 인자이며, rsi는 두 번째 인자입니다. */
     /* Call the kernel_thread if it scheduled.
@@ -314,13 +634,25 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
     t->tf.es = SEL_KDSEG;
     t->tf.ss = SEL_KDSEG;
     t->tf.cs = SEL_KCSEG;
-    t->tf.eflags = FLAG_IF;
+    /* 처음 실행될 때 스레드는 아직 실행 큐 락을 잡고 있으므로 인터럽트를 끈 채로
+       시작합니다. kernel_thread()가 락을 놓은 뒤 인터럽트를 켭니다. */
+    /* The thread first runs still holding the run queue lock, so
+       it starts with interrupts off; kernel_thread() turns them on
+       once the lock is dropped. */
+    t->tf.eflags = FLAG_MBS;
 
     // for project 2 sys call
     // t->fdt = palloc_get_multiple(PAL_ZERO, 256);
-    t->fdt = palloc_get_page(PAL_ZERO); // 4KB 메모리를 할당 (한 페이지의 크기, 파일 테이블에 1개의 페이지를 할당한다.)
+    t->fdt = obj_cache_get(&fdt_cache); // 4KB 메모리를 할당 (한 페이지의 크기, 파일 테이블에 1개의 페이지를 할당한다.)
     if (t->fdt == NULL) {
-        palloc_free_page(t); 
+        // init_thread()가 all_list에 넣었으므로, 캐시에 돌려주기 전에 빼야 합니다.
+        old_level = intr_disable();
+        all_list_remove(t);
+        spinlock_acquire(&this_cpu()->rq_lock);
+        cpu_group_put(t->cpu_group);
+        spinlock_release(&this_cpu()->rq_lock);
+        intr_set_level(old_level);
+        obj_cache_put(&thread_cache, t);
         return TID_ERROR;
     }
     t->fd_idx = 3;
@@ -344,6 +676,75 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
     return tid;
 }
 
+/* 종료를 기다려 준 자식 CHILD의 사용량과 CHILD가 회수한 자식들의 사용량을
+   현재 스레드의 child_rusage에 더합니다. */
+/* Adds the usage of CHILD, which has exited and been waited for,
+   and of the children it waited for in turn, to the running
+   thread's child_rusage. */
+void thread_rusage_collect(struct thread *child) {
+    struct rusage *dst = &thread_current()->child_rusage;
+
+    rusage_add(dst, &child->rusage);
+    rusage_add(dst, &child->child_rusage);
+}
+
+/* 끝나서 거둔 추가 스레드 MEMBER의 사용량을 주 스레드에 더합니다. MEMBER가 쓴 시간은
+   프로세스 자신의 사용량이 되고, MEMBER가 기다려 준 자식들의 사용량은 프로세스의
+   자식 사용량이 됩니다. */
+/* Folds the usage of MEMBER, an extra thread of a process that
+   has exited and been reaped, into the process's main thread:
+   MEMBER's own usage into the process's, and that of the
+   children MEMBER waited for into the process's child usage. */
+void thread_rusage_absorb(struct thread *member) {
+    struct thread *leader = member->leader;
+    enum intr_level old_level;
+
+    ASSERT(leader != member);
+
+    /* 주 스레드가 실행 중이면 타이머 인터럽트가 그 사용량을 늘립니다. */
+    /* The timer interrupt updates the main thread's usage if it
+       is running. */
+    old_level = intr_disable();
+    rusage_add(&leader->rusage, &member->rusage);
+    rusage_add(&leader->child_rusage, &member->child_rusage);
+    intr_set_level(old_level);
+}
+
+/* 현재 프로세스의 사용량을 USAGE에 저장합니다. 주 스레드와 이미 거둔 스레드, 아직
+   살아 있는 추가 스레드의 사용량을 합합니다. CHILDREN이면 대신 기다려 준 자식들의
+   사용량을 저장합니다. */
+/* Stores in *USAGE the usage of the running thread's process:
+   that of its main thread, which includes the threads already
+   reaped, plus that of the extra threads still around.  If
+   CHILDREN, stores the usage of the children waited for
+   instead. */
+void thread_rusage_process(bool children, struct rusage *usage) {
+    struct thread *leader = thread_current()->leader;
+    enum intr_level old_level;
+    struct list_elem *e;
+
+    old_level = intr_disable();
+    *usage = children ? leader->child_rusage : leader->rusage;
+    for (e = list_begin(&leader->members); e != list_end(&leader->members); e = list_next(e)) {
+        struct thread *m = list_entry(e, struct thread, member_elem);
+
+        rusage_add(usage, children ? &m->child_rusage : &m->rusage);
+    }
+    intr_set_level(old_level);
+}
+
+/* SRC의 사용량을 DST에 더합니다. */
+/* Adds the usage in SRC to DST. */
+static void rusage_add(struct rusage *dst, const struct rusage *src) {
+    dst->utime += src->utime;
+    dst->stime += src->stime;
+    dst->nvcsw += src->nvcsw;
+    dst->nivcsw += src->nivcsw;
+    dst->page_faults += src->page_faults;
+    dst->sectors_read += src->sectors_read;
+    dst->sectors_written += src->sectors_written;
+}
+
 /* 현재 스레드를 슬립 상태로 전환합니다. thread_unblock()에 의해 다시 스케줄되기 전까지
    스케줄되지 않습니다.
 
@@ -358,10 +759,29 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
 void thread_block(void) {
     ASSERT(!intr_context());
     ASSERT(intr_get_level() == INTR_OFF);
+    spinlock_acquire(&this_cpu()->rq_lock);
     thread_current()->status = THREAD_BLOCKED;
     schedule();
 }
 
+/* GUARD를 잡은 상태에서 호출하여, GUARD를 놓는 것과 잠드는 것을 원자적으로 수행합니다.
+   실행 큐 락을 먼저 잡은 뒤 GUARD를 놓으므로, 다른 CPU의 thread_unblock()은
+   이 스레드가 완전히 전환될 때까지 기다립니다. 반환 시 GUARD는 잡혀 있지 않습니다. */
+/* Like thread_block(), but atomically releases GUARD, which the
+   caller holds, as it goes to sleep.  The run queue lock is taken
+   before GUARD is dropped, so a waker on another CPU cannot
+   unblock us until we have switched away.  We are already marked
+   THREAD_BLOCKED when GUARD is dropped, so a waker that holds
+   GUARD may rely on the status.  GUARD is not held on return. */
+void thread_block_on(struct spinlock *guard) {
+    ASSERT(!intr_context());
+    ASSERT(intr_get_level() == INTR_OFF);
+    spinlock_acquire(&this_cpu()->rq_lock);
+    thread_current()->status = THREAD_BLOCKED;
+    spinlock_release(guard);
+    schedule();
+}
+
 /* 차단된 스레드 T를 실행 준비가 된 상태로 전환합니다.
    이는 T가 차단되지 않은 경우에는 오류입니다. (실행 중인 스레드를 준비 상태로 만들려면
    thread_yield()를 사용하세요.)
@@ -378,56 +798,90 @@ void thread_block(void) {
    it may expect that it can atomically unblock a thread and
    update other data. */
 void thread_unblock(struct thread *t) {
+    struct cpu *c = this_cpu();
     enum intr_level old_level;
 
     ASSERT(is_thread(t));
 
     old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
     ASSERT(t->status == THREAD_BLOCKED);
-    // list_push_back(&ready_list, &t->elem);
-    list_insert_desc_ordered(&ready_list, &t->elem, less_priority, PRIORITY);
+    if (thread_cfs) {
+        /* 오래 잠들었던 스레드가 밀린 몫을 한꺼번에 가져가지 못하도록,
+           min_vruntime보다 반 주기 이상 뒤처지지 않게 합니다. */
+        /* A long sleeper may not bank its sleep: it rejoins at most
+           half a period behind min_vruntime. */
+        uint64_t floor = c->min_vruntime - CFS_LATENCY * CFS_TICK / 2;
+        if (c->min_vruntime >= CFS_LATENCY * CFS_TICK / 2 && t->vruntime < floor)
+            t->vruntime = floor;
+    }
+    if (edf_active(t) && t->edf_deadline < timer_ticks()) {
+        /* 마감이 지난 뒤 깨어난 EDF 스레드는 지금부터 새 주기를 시작합니다. */
+        /* An EDF thread waking past its deadline starts a fresh
+           period now rather than jumping the queue with a stale
+           deadline. */
+        t->edf_deadline = timer_ticks() + t->edf_period;
+        t->edf_budget = t->edf_runtime;
+    }
+    ready_push(t);
     t->status = THREAD_READY;
+    sched_trace(SCHED_EV_WAKEUP, t, intr_context() ? NULL : running_thread(), t->priority);
+    sched_trace_ready(t);
+    spinlock_release(&c->rq_lock);
     intr_set_level(old_level);
 }
 
-/* 값 비교. t1의 우선순위가 낮은 경우 true*/
-bool less_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-    struct thread *t1 = list_entry(e1, struct thread, elem);
-    struct thread *t2 = list_entry(e2, struct thread, elem);
-    int t1_priority = t1->priority;
-    int t2_priority = t2->priority;
+// 우선순위 스케줄링 하는 함수
+void test_max_priority(void) {
+    struct thread *curr = thread_current();
+    int highest;
 
-    if (t1_priority < t2_priority) {
-        return true;
+    // edf: 예산이 남은 EDF 스레드는 마감 순서로만 서로 선점합니다.
+    if (edf_should_preempt(curr)) {
+        if (!intr_context())
+            thread_yield();
+        return;
     }
-    return false;
-}
-/* 값 비교. t1의 우선순위가 낮은 경우 false*/
-bool more_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-    struct thread *t1 = list_entry(e1, struct thread, elem);
-    struct thread *t2 = list_entry(e2, struct thread, elem);
-    int t1_priority = t1->priority;
-    int t2_priority = t2->priority;
+    if (edf_active(curr))
+        return;
 
-    if (t1_priority > t2_priority) {
-        return true;
+    // cfs: 우선순위 대신 vruntime으로 판단합니다.
+    if (thread_cfs) {
+        if (!intr_context() && cfs_should_preempt(curr))
+            thread_yield();
+        return;
     }
-    return false;
-}
-
-// 우선순위 스케줄링 하는 함수
-void test_max_priority(void) {
-    struct thread *curr = thread_current();
-    struct list_elem *highest_elem = list_begin(&ready_list);
-    if (list_end(&ready_list) == (highest_elem)) {
+    highest = ready_max_priority();
+    if (highest < 0) {
         return;
     }
-    // 인터럽트 컨텍스트가 아니고, 현재 스레드의 우선순위가 준비 리스트의 최고 우선순위 스레드보다 낮다면
-    if (!intr_context() && less_priority(&curr->elem, highest_elem, NULL)) {
+    // 인터럽트 컨텍스트가 아니고, 현재 스레드의 우선순위가 준비 큐의 최고 우선순위보다 낮다면
+    if (!intr_context() && curr->priority < highest) {
         thread_yield();
     }
 }
 
+/* T의 우선순위를 PRIORITY로 바꿉니다. T가 준비 큐에 있다면 새 우선순위의 큐 뒤로 옮기고,
+   대기 큐에 있다면 그 안에서 위치를 다시 잡습니다. */
+/* Changes T's priority to PRIORITY, moving T to the tail of the
+   matching ready queue if it is currently ready to run, or to its
+   new place in the wait queue it is waiting in. */
+void thread_update_priority(struct thread *t, int priority) {
+    struct cpu *c = this_cpu();
+    enum intr_level old_level = intr_disable();
+
+    spinlock_acquire(&c->rq_lock);
+    if (t->status == THREAD_READY && t->priority != priority && !thread_cfs) {
+        ready_remove(t);
+        t->priority = priority;
+        ready_push(t);
+    } else
+        t->priority = priority;
+    spinlock_release(&c->rq_lock);
+    wait_queue_update(t);
+    intr_set_level(old_level);
+}
+
 /* 실행 중인 스레드의 이름을 반환합니다. */
 /* Returns the name of the running thread. */
 const char *thread_name(void) {
@@ -479,6 +933,12 @@ void thread_exit(void) {
     /* Just set our status to dying and schedule another process.
        We will be destroyed during the call to schedule_tail(). */
     intr_disable();
+    all_list_remove(thread_current());
+    spinlock_acquire(&this_cpu()->rq_lock);
+    edf_leave(this_cpu(), thread_current());
+    cpu_group_put(thread_current()->cpu_group);
+    cpu_group_disown(thread_current());
+    spinlock_release(&this_cpu()->rq_lock);
     do_schedule(THREAD_DYING);
     NOT_REACHED();
 }
@@ -488,16 +948,11 @@ void thread_exit(void) {
 /* Yields the CPU.  The current thread is not put to sleep and
    may be scheduled again immediately at the scheduler's whim. */
 void thread_yield(void) {
-    struct thread *curr = thread_current();
     enum intr_level old_level;
 
     ASSERT(!intr_context());
     
     old_level = intr_disable();
-    if (curr != idle_thread) {
-        // list_push_back(&ready_list, &curr->elem);
-        list_insert_desc_ordered(&ready_list, &curr->elem, less_priority, PRIORITY);
-    }
     do_schedule(THREAD_READY);
     intr_set_level(old_level);
 }
@@ -505,6 +960,10 @@ void thread_yield(void) {
 /* 현재 스레드의 우선순위를 NEW_PRIORITY로 설정합니다. */
 /* Sets the current thread's priority to NEW_PRIORITY. */
 void thread_set_priority(int new_priority) {
+    // mlfqs에서는 스케줄러가 우선순위를 직접 계산하므로 무시합니다.
+    if (thread_mlfqs)
+        return;
+
     thread_current()->init_priority = new_priority;
 
     refresh_priority();
@@ -519,29 +978,736 @@ int thread_get_priority(void) {
 
 /* 현재 스레드의 nice 값을 NICE로 설정합니다. */
 /* Sets the current thread's nice value to NICE. */
-void thread_set_nice(int nice UNUSED) {
-    /* TODO: Your implementation goes here */
+void thread_set_nice(int nice) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+
+    ASSERT(NICE_MIN <= nice && nice <= NICE_MAX);
+
+    old_level = intr_disable();
+    curr->nice = nice;
+    if (thread_mlfqs) {
+        mlfqs_decay(curr);
+        curr->priority = mlfqs_priority(curr);
+    }
+    intr_set_level(old_level);
+
+    test_max_priority();
 }
 
 /* 현재 스레드의 nice 값을 반환합니다. */
 /* Returns the current thread's nice value. */
 int thread_get_nice(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    return thread_current()->nice;
+}
+
+/* 현재 스레드를 주기 PERIOD마다 RUNTIME 틱을 받는 EDF 스레드로 만듭니다.
+   첫 마감은 지금부터 PERIOD 틱 뒤입니다. 둘 다 0이면 EDF에서 빠집니다.
+   이용률 합이 EDF_UTIL_MAX를 넘게 되면 허용하지 않고 false를 반환합니다. */
+/* Makes the running thread an EDF thread entitled to RUNTIME
+   ticks of CPU every PERIOD ticks, with its first deadline
+   PERIOD ticks from now, or takes it out of the EDF class if
+   both are 0.  Returns false, changing nothing, if the arguments
+   are invalid or admitting the thread would push the total EDF
+   utilization past EDF_UTIL_MAX. */
+bool thread_set_deadline(int64_t runtime, int64_t period) {
+    struct thread *curr = thread_current();
+    struct cpu *c = this_cpu();
+    enum intr_level old_level;
+    int util = 0;
+    bool ok = false;
+
+    if (runtime != 0 || period != 0) {
+        if (runtime <= 0 || period <= 0 || runtime > period)
+            return false;
+        util = DIV_ROUND_UP(runtime * 1000, period);
+    }
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
+    if (c->edf_util - edf_util(curr) + util <= EDF_UTIL_MAX) {
+        edf_leave(c, curr);
+        if (util != 0) {
+            curr->edf_runtime = runtime;
+            curr->edf_period = period;
+            curr->edf_deadline = timer_ticks() + period;
+            curr->edf_budget = runtime;
+            curr->edf_misses = 0;
+            c->edf_util += util;
+        }
+        ok = true;
+    }
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+
+    test_max_priority();
+    return ok;
+}
+
+/* EDF 스레드가 이번 주기의 작업을 마쳤을 때 호출합니다. 다음 주기가 시작될 때까지 잠들고,
+   작업이 마감 안에 끝났으면 true를 반환합니다. 늦었으면 지금 이후의 첫 주기로 건너뜁니다. */
+/* Called by an EDF thread when it has finished the work of its
+   current period.  Returns true if the work was done by the
+   deadline.  Sleeps until the next period begins, which is the
+   old deadline, or, if the deadline was missed, right away with
+   the deadline moved to the first period boundary after now. */
+bool thread_edf_next_period(void) {
+    struct thread *curr = thread_current();
+    struct cpu *c = this_cpu();
+    enum intr_level old_level;
+    int64_t now, release;
+    bool met;
+
+    ASSERT(curr->edf_period != 0);
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
+    now = timer_ticks();
+    met = now <= curr->edf_deadline;
+    if (met) {
+        release = curr->edf_deadline;
+        curr->edf_deadline += curr->edf_period;
+    } else {
+        curr->edf_misses++;
+        release = now;
+        while (curr->edf_deadline <= now)
+            curr->edf_deadline += curr->edf_period;
+    }
+    if (curr->edf_throttled) {
+        heap_remove(&c->edf_throttled, &curr->edf_elem);
+        curr->edf_throttled = false;
+    }
+    curr->edf_budget = curr->edf_runtime;
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+
+    if (release > now)
+        thread_sleep(release);
+    return met;
+}
+
+/* 현재 스레드가 EDF 스레드가 된 뒤 놓친 마감 수를 반환합니다. */
+/* Returns the number of deadlines the running thread has missed
+   since it last called thread_set_deadline(). */
+int thread_get_deadline_misses(void) {
+    return thread_current()->edf_misses;
 }
 
 /* 시스템 로드 평균의 100배를 반환합니다. */
 /* Returns 100 times the system load average. */
 int thread_get_load_avg(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    enum intr_level old_level = intr_disable();
+    int load = fp_round(fp_mul_int(load_avg, 100));
+    intr_set_level(old_level);
+    return load;
 }
 
 /* 현재 스레드의 recent_cpu 값의 100배를 반환합니다. */
 /* Returns 100 times the current thread's recent_cpu value. */
 int thread_get_recent_cpu(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    enum intr_level old_level = intr_disable();
+    int recent;
+
+    if (thread_mlfqs)
+        mlfqs_decay(thread_current());
+    recent = fp_round(fp_mul_int(thread_current()->recent_cpu, 100));
+    intr_set_level(old_level);
+    return recent;
+}
+
+/* mlfqs: priority = PRI_MAX - (recent_cpu / 4) - (nice * 2), [PRI_MIN, PRI_MAX]로 잘라냅니다. */
+/* MLFQS priority of T: PRI_MAX - (recent_cpu / 4) - (nice * 2),
+   clamped to [PRI_MIN, PRI_MAX]. */
+static int mlfqs_priority(const struct thread *t) {
+    int priority = PRI_MAX - fp_to_int(fp_div_int(t->recent_cpu, 4)) - t->nice * 2;
+
+    if (priority < PRI_MIN)
+        return PRI_MIN;
+    if (priority > PRI_MAX)
+        return PRI_MAX;
+    return priority;
+}
+
+/* 타이머 틱마다 인터럽트 컨텍스트에서 호출됩니다.
+   4틱마다 우선순위를 다시 계산하지만, 그 사이 recent_cpu가 바뀐 스레드는
+   실행 중인 스레드 T뿐이므로 T만 계산합니다. 1초마다의 감쇠는 모든 스레드를
+   한 번에 돌지 않고, 틱마다 몇 개씩 나누어 합니다. */
+/* Per-tick MLFQS bookkeeping, in external interrupt context.
+   Priorities are due every fourth tick, but between two decays
+   only the running thread T has had its recent_cpu change, so
+   only T is recomputed.  The once-a-second decay does not walk
+   all_list in one go: it is handed out a few threads per tick. */
+static void mlfqs_tick(struct thread *t) {
+    struct thread *idle_thread = this_cpu()->idle_thread;
+    int64_t ticks = timer_ticks();
+
+    if (t != idle_thread) {
+        mlfqs_decay(t);
+        t->recent_cpu = fp_add_int(t->recent_cpu, 1);
+    }
+
+    if (ticks % TIMER_FREQ == 0) {
+        int ready_threads = this_cpu()->ready_cnt + (t != idle_thread ? 1 : 0);
+        fixed_t twice_load;
+
+        load_avg = fp_add(fp_mul(fp_div_int(fp_from_int(59), 60), load_avg),
+                          fp_mul_int(fp_div_int(fp_from_int(1), 60), ready_threads));
+        twice_load = fp_mul_int(load_avg, 2);
+        decay_epoch++;
+        decay_hist[decay_epoch % MLFQS_DECAY_HIST] = fp_div(twice_load, fp_add_int(twice_load, 1));
+    }
+    if (t != idle_thread && (t->decay_epoch != decay_epoch || ticks % 4 == 0)) {
+        mlfqs_decay(t);
+        t->priority = mlfqs_priority(t);
+    }
+    mlfqs_decay_batch();
+
+    if (t != idle_thread && ready_max_priority() > t->priority)
+        intr_yield_on_return();
+}
+
+/* T의 recent_cpu에 밀린 감쇠를 모두 적용합니다. 너무 오래 밀려 decay_hist에 남아
+   있지 않은 초에는 남아 있는 가장 오래된 계수를 씁니다. */
+/* Applies to T's recent_cpu every decay it has missed.  For
+   seconds too old to still be in decay_hist, the oldest factor
+   kept there stands in. */
+static void mlfqs_decay(struct thread *t) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    while (t->decay_epoch < decay_epoch) {
+        int64_t epoch = ++t->decay_epoch;
+
+        if (decay_epoch - epoch >= MLFQS_DECAY_HIST)
+            epoch = decay_epoch - MLFQS_DECAY_HIST + 1;
+        t->recent_cpu = fp_add_int(fp_mul(decay_hist[epoch % MLFQS_DECAY_HIST], t->recent_cpu), t->nice);
+    }
+}
+
+/* all_list를 따라 스레드를 최대 MLFQS_DECAY_BATCH개 감쇠시키고 우선순위를 다시
+   계산합니다. 초가 바뀌어도 훑기를 처음부터 다시 시작하지 않고 이어 가며, 끝에
+   닿았을 때 그 사이에 새 초가 시작되었으면 맨 앞으로 돌아갑니다. 그래서 1초에
+   훑을 수 있는 것보다 스레드가 많아도 뒤쪽 스레드가 빠지지 않습니다. */
+/* Decays up to MLFQS_DECAY_BATCH threads along all_list and
+   recomputes their priorities.  A new second does not restart
+   the pass; the pass carries on, and on reaching the end wraps
+   to the front if a second has begun since it started.  With
+   more threads than one second of batches covers, the tail is
+   still reached, just a little later. */
+static void mlfqs_decay_batch(void) {
+    int i;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    for (i = 0; i < MLFQS_DECAY_BATCH; i++) {
+        struct thread *t;
+
+        if (decay_cursor == list_end(&all_list)) {
+            if (decay_pass_epoch == decay_epoch)
+                break;
+            decay_cursor = list_begin(&all_list);
+            decay_pass_epoch = decay_epoch;
+        }
+        t = list_entry(decay_cursor, struct thread, all_elem);
+
+        decay_cursor = list_next(decay_cursor);
+        if (t == this_cpu()->idle_thread)
+            continue;
+        mlfqs_decay(t);
+        thread_update_priority(t, mlfqs_priority(t));
+    }
+}
+
+/* T를 all_list에서 뺍니다. 감쇠 차례가 T였다면 다음 스레드로 넘깁니다.
+   인터럽트가 꺼져 있어야 합니다. */
+/* Removes T from all_list, moving the decay cursor past it if
+   it was next.  Interrupts must be off. */
+static void all_list_remove(struct thread *t) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (decay_cursor == &t->all_elem)
+        decay_cursor = list_next(decay_cursor);
+    list_remove(&t->all_elem);
+}
+
+/* cfs_tree의 비교 함수입니다. vruntime이 작은 스레드가 앞서고, 같으면 먼저 들어온 스레드가 앞섭니다. */
+/* Orders cfs_tree by vruntime.  The tree keeps equal keys in
+   insertion order. */
+static bool cfs_less(const struct rb_node *a, const struct rb_node *b, void *aux UNUSED) {
+    return rb_entry(a, struct thread, cfs_node)->vruntime < rb_entry(b, struct thread, cfs_node)->vruntime;
+}
+
+/* T의 nice 값에 해당하는 가중치를 반환합니다. */
+/* Returns the weight of T's nice value. */
+static int cfs_weight(const struct thread *t) {
+    return cfs_weights[t->nice - NICE_MIN];
+}
+
+/* 타이머 틱마다 인터럽트 컨텍스트에서 호출됩니다. 실행 중인 스레드 T의 vruntime을
+   가중치에 반비례해 늘리고, min_vruntime을 앞으로 옮기며, 더 뒤처진 스레드가 있으면 선점합니다. */
+/* Per-tick bookkeeping for the weighted fair scheduler, in
+   external interrupt context.  Charges the tick to the running
+   thread T in inverse proportion to its weight, advances
+   min_vruntime, and preempts T if a ready thread has fallen far
+   enough behind it, such as one the timer just woke up. */
+static void cfs_tick(struct thread *t) {
+    struct cpu *c = this_cpu();
+    struct rb_node *first = rb_first(&c->cfs_tree);
+    uint64_t floor = UINT64_MAX;
+
+    if (t != c->idle_thread) {
+        t->vruntime += (uint64_t)CFS_TICK * NICE_0_WEIGHT / cfs_weight(t);
+        floor = t->vruntime;
+    }
+    if (first != NULL && rb_entry(first, struct thread, cfs_node)->vruntime < floor)
+        floor = rb_entry(first, struct thread, cfs_node)->vruntime;
+    if (floor != UINT64_MAX && floor > c->min_vruntime)
+        c->min_vruntime = floor;
+
+    if (t != c->idle_thread && cfs_should_preempt(t))
+        intr_yield_on_return();
+}
+
+/* 실행 큐에서 막 꺼낸 NEXT의 타임 슬라이스를 틱 단위로 반환합니다.
+   CFS_LATENCY 주기를 준비된 스레드들의 가중치 비율로 나누며, 스레드가 많으면 주기를 늘립니다. */
+/* Returns the time slice, in ticks, for NEXT, just taken off
+   C's run queue: NEXT's weighted share of a period of
+   CFS_LATENCY ticks.  With more ready threads than fit in that
+   period at CFS_MIN_GRANULARITY each, the period stretches
+   instead. */
+static unsigned cfs_slice(const struct cpu *c, const struct thread *next) {
+    unsigned nr_running = c->ready_cnt + 1;
+    uint64_t period = CFS_LATENCY;
+    uint64_t weight, slice;
+
+    if (next == c->idle_thread)
+        return CFS_MIN_GRANULARITY;
+    if (nr_running > CFS_LATENCY / CFS_MIN_GRANULARITY)
+        period = (uint64_t)nr_running * CFS_MIN_GRANULARITY;
+
+    weight = cfs_weight(next);
+    slice = period * weight / (c->cfs_weight + weight);
+    return slice < CFS_MIN_GRANULARITY ? CFS_MIN_GRANULARITY : slice;
+}
+
+/* vruntime이 가장 작은 준비 스레드가 CURR보다 CFS_WAKEUP_GRANULARITY 틱 넘게 뒤처졌으면 true를 반환합니다. */
+/* Returns true if the ready thread with the least vruntime
+   trails CURR by more than CFS_WAKEUP_GRANULARITY ticks' worth,
+   so that CURR should give way to it. */
+static bool cfs_should_preempt(const struct thread *curr) {
+    struct cpu *c = this_cpu();
+    enum intr_level old_level = intr_disable();
+    struct rb_node *first;
+    bool preempt = false;
+
+    spinlock_acquire(&c->rq_lock);
+    first = rb_first(&c->cfs_tree);
+    if (first != NULL)
+        preempt = curr == c->idle_thread
+                  || rb_entry(first, struct thread, cfs_node)->vruntime
+                         + CFS_WAKEUP_GRANULARITY * CFS_TICK < curr->vruntime;
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return preempt;
+}
+
+/* edf_queue와 edf_throttled의 비교 함수입니다. 마감이 이른 스레드가 위로 올라갑니다. */
+/* Orders edf_queue and edf_throttled by deadline. */
+static bool edf_less(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED) {
+    return heap_entry(a, struct thread, edf_elem)->edf_deadline < heap_entry(b, struct thread, edf_elem)->edf_deadline;
+}
+
+/* T가 EDF 스레드이고 이번 주기의 예산이 남았으면 true를 반환합니다.
+   예산을 다 쓴 EDF 스레드는 다음 보충까지 일반 스레드로 스케줄됩니다. */
+/* Returns true if T is an EDF thread with budget left in its
+   period.  One that has used up its budget is scheduled as a
+   normal thread until the budget is replenished. */
+static bool edf_active(const struct thread *t) {
+    return t->edf_period != 0 && t->edf_budget > 0;
+}
+
+/* T가 차지하는 EDF 이용률을 천분율로 반환합니다. */
+/* Returns T's EDF utilization, in per mille. */
+static int edf_util(const struct thread *t) {
+    if (t->edf_period == 0)
+        return 0;
+    return DIV_ROUND_UP(t->edf_runtime * 1000, t->edf_period);
+}
+
+/* 실행 중인 스레드 T를 EDF에서 빼고 이용률을 돌려줍니다. 실행 큐 락을 잡은 상태에서 호출해야 합니다. */
+/* Takes T, which must be running, out of the EDF class and
+   gives back its utilization.  The run queue lock must be
+   held. */
+static void edf_leave(struct cpu *c, struct thread *t) {
+    ASSERT(spinlock_held(&c->rq_lock));
+
+    c->edf_util -= edf_util(t);
+    if (t->edf_throttled) {
+        heap_remove(&c->edf_throttled, &t->edf_elem);
+        t->edf_throttled = false;
+    }
+    t->edf_runtime = t->edf_period = t->edf_budget = 0;
+}
+
+/* 타이머 틱마다 인터럽트 컨텍스트에서 호출됩니다. 실행 중인 EDF 스레드 T의 예산을 깎고,
+   마감에 이른 스레드의 예산을 보충하며, T가 양보해야 하면 true를 반환합니다.
+   예산을 다 쓴 채 마감을 맞은 스레드는 작업을 끝내지 못한 것이므로 놓친 마감으로 셉니다. */
+/* Per-tick EDF bookkeeping, in external interrupt context.
+   Charges the tick to T if it is a running EDF thread, throttling
+   T once its budget is gone, and replenishes every throttled
+   thread whose deadline has arrived, counting a miss for each:
+   its work for that period did not fit in its runtime.  Returns
+   true if T should yield. */
+static bool edf_tick(struct thread *t) {
+    struct cpu *c = this_cpu();
+    int64_t now = timer_ticks();
+    struct heap_elem *e;
+    bool yield = false;
+
+    spinlock_acquire(&c->rq_lock);
+    if (t != c->idle_thread && edf_active(t) && --t->edf_budget == 0) {
+        t->edf_throttled = true;
+        heap_push(&c->edf_throttled, &t->edf_elem);
+        yield = true;
+    }
+    while ((e = heap_top(&c->edf_throttled)) != NULL
+           && heap_entry(e, struct thread, edf_elem)->edf_deadline <= now) {
+        struct thread *u = heap_entry(heap_pop(&c->edf_throttled), struct thread, edf_elem);
+        bool ready = u->status == THREAD_READY;
+
+        if (ready)
+            ready_remove(u);
+        u->edf_throttled = false;
+        u->edf_misses++;
+        while (u->edf_deadline <= now)
+            u->edf_deadline += u->edf_period;
+        u->edf_budget = u->edf_runtime;
+        if (ready)
+            ready_push(u);
+    }
+    spinlock_release(&c->rq_lock);
+
+    return yield || edf_should_preempt(t);
+}
+
+/* 예산이 남은 EDF 스레드가 준비되어 있고, CURR가 EDF 스레드가 아니거나
+   그보다 마감이 늦으면 true를 반환합니다. */
+/* Returns true if a ready EDF thread should run instead of CURR:
+   one is ready and CURR either is not an active EDF thread or
+   has a later deadline. */
+static bool edf_should_preempt(const struct thread *curr) {
+    struct cpu *c = this_cpu();
+    enum intr_level old_level = intr_disable();
+    struct heap_elem *top;
+    bool preempt = false;
+
+    spinlock_acquire(&c->rq_lock);
+    top = heap_top(&c->edf_queue);
+    if (top != NULL)
+        preempt = curr == c->idle_thread || !edf_active(curr)
+                  || heap_entry(top, struct thread, edf_elem)->edf_deadline < curr->edf_deadline;
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return preempt;
+}
+
+/* 그룹 G의 참조를 하나 늘립니다. 실행 큐 락을 잡은 상태에서 호출해야 합니다. */
+/* Takes a reference to group G.  The run queue lock must be
+   held. */
+static void cpu_group_get(struct cpu_group *g) {
+    ASSERT(spinlock_held(&this_cpu()->rq_lock));
+    g->ref_cnt++;
+}
+
+/* 그룹 G의 참조를 하나 줄이고, 마지막이면 슬롯을 비우고 부모의 참조도 놓습니다. */
+/* Drops a reference to group G.  When the last one goes, frees
+   G's slot and drops G's reference to its parent.  The run queue
+   lock must be held. */
+static void cpu_group_put(struct cpu_group *g) {
+    ASSERT(spinlock_held(&this_cpu()->rq_lock));
+
+    while (g != NULL && --g->ref_cnt == 0) {
+        struct cpu_group *parent = g->parent;
+
+        ASSERT(list_empty(&g->parked));
+        if (g->throttled)
+            list_remove(&g->throttled_elem);
+        g->throttled = false;
+        g->parent = NULL;
+        g = parent;
+    }
+}
+
+/* T의 그룹이나 그 조상 중 멈춘 가장 가까운 그룹을 반환하고, 없으면 NULL을 반환합니다. */
+/* Returns the nearest throttled group on the path from T's group
+   to the root, or a null pointer if there is none. */
+static struct cpu_group *cpu_group_throttled(const struct thread *t) {
+    struct cpu_group *g;
+
+    for (g = t->cpu_group; g != NULL; g = g->parent)
+        if (g->throttled)
+            return g;
+    return NULL;
+}
+
+/* T의 그룹 경로에 멈춘 그룹이 있으면 T를 그 그룹에 세워 두고 true를 반환합니다.
+   세워 둔 스레드는 상태가 THREAD_READY인 채로 실행 큐 밖에 있습니다. */
+/* If a group on T's path to the root is throttled, parks T on it
+   and returns true.  A parked thread stays THREAD_READY but is
+   off the run queue until the group is unthrottled. */
+static bool cpu_group_park(struct thread *t) {
+    struct cpu_group *g = cpu_group_throttled(t);
+
+    if (g == NULL)
+        return false;
+    list_push_back(&g->parked, &t->elem);
+    t->parked_on = g;
+    return true;
+}
+
+/* 멈춘 그룹 G를 NOW에 다시 풀고, 세워 둔 스레드를 실행 큐로 돌려보냅니다.
+   다른 조상 그룹이 여전히 멈춰 있으면 그 스레드는 그쪽에 다시 세워집니다. */
+/* Unthrottles group G at NOW, starting its next period, and
+   requeues the threads parked on it.  A thread that still has a
+   throttled ancestor is parked again on that one. */
+static void cpu_group_unthrottle(struct cpu_group *g, int64_t now) {
+    ASSERT(g->throttled);
+
+    list_remove(&g->throttled_elem);
+    g->throttled = false;
+    g->throttled_ticks += now - g->throttled_since;
+    g->runtime = 0;
+    while (g->period_end <= now)
+        g->period_end += g->period;
+    while (!list_empty(&g->parked)) {
+        struct thread *t = list_entry(list_pop_front(&g->parked), struct thread, elem);
+
+        t->parked_on = NULL;
+        ready_push(t);
+    }
+}
+
+/* 타이머 틱마다 인터럽트 컨텍스트에서 호출됩니다. 주기가 끝난 그룹을 풀고,
+   틱을 실행 중인 스레드 T의 그룹 경로에 청구하며, T의 그룹이 멈췄으면 true를 반환합니다. */
+/* Per-tick bandwidth bookkeeping, in external interrupt context.
+   Unthrottles the groups whose period is over, then charges the
+   tick to every group on the running thread T's path to the
+   root, throttling any that run out of quota.  Returns true if T
+   must yield because its group is now throttled. */
+static bool cpu_group_tick(struct thread *t) {
+    struct cpu *c = this_cpu();
+    int64_t now = timer_ticks();
+    struct list_elem *e, *next;
+    struct cpu_group *g;
+    bool throttled;
+
+    spinlock_acquire(&c->rq_lock);
+    for (e = list_begin(&throttled_groups); e != list_end(&throttled_groups); e = next) {
+        next = list_next(e);
+        g = list_entry(e, struct cpu_group, throttled_elem);
+        if (g->period_end <= now)
+            cpu_group_unthrottle(g, now);
+    }
+
+    if (t == c->idle_thread) {
+        spinlock_release(&c->rq_lock);
+        return false;
+    }
+    for (g = t->cpu_group; g != NULL; g = g->parent) {
+        g->consumed_ticks++;
+        if (g->quota == 0)
+            continue;
+        if (g->period_end <= now) {
+            g->runtime = 0;
+            while (g->period_end <= now)
+                g->period_end += g->period;
+        }
+        if (++g->runtime >= g->quota && !g->throttled) {
+            g->throttled = true;
+            g->throttled_since = now;
+            g->throttle_cnt++;
+            list_push_back(&throttled_groups, &g->throttled_elem);
+        }
+    }
+    throttled = cpu_group_throttled(t) != NULL;
+    spinlock_release(&c->rq_lock);
+    return throttled;
+}
+
+/* PARENT 그룹 아래에 주기 PERIOD마다 QUOTA 틱을 쓸 수 있는 그룹을 만들고 번호를 반환합니다.
+   QUOTA가 0이면 제한이 없습니다. PARENT는 현재 스레드의 그룹이거나 그 자손이어야 합니다.
+   실패하면 -1을 반환합니다. 만든 프로세스가 끝나고 구성원도 모두 떠나면 그룹은 해제됩니다. */
+/* Creates a group under group PARENT that may use QUOTA ticks of
+   CPU every PERIOD ticks, or is unlimited if QUOTA is 0, and
+   returns its id.  PARENT must be the running thread's group or
+   one below it.  Returns -1 if the arguments are invalid or
+   every slot is in use.  The creating process holds a reference
+   to the group until it exits, and the group goes away once
+   that and every member are gone. */
+int thread_group_create(int parent, int64_t quota, int64_t period) {
+    struct thread *curr = thread_current();
+    struct cpu *c = this_cpu();
+    enum intr_level old_level;
+    int id = -1;
+
+    if (parent < 0 || parent >= CPU_GROUP_MAX || quota < 0 || period <= 0 || quota > period)
+        return -1;
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
+    if (cpu_groups[parent].ref_cnt != 0 && cpu_group_within(&cpu_groups[parent], curr->cpu_group)) {
+        for (int i = 1; i < CPU_GROUP_MAX; i++) {
+            struct cpu_group *g = &cpu_groups[i];
+
+            if (g->ref_cnt != 0)
+                continue;
+            g->parent = &cpu_groups[parent];
+            cpu_group_get(g->parent);
+            g->ref_cnt = 1;
+            g->owner = curr->leader;
+            g->quota = quota;
+            g->period = period;
+            g->runtime = 0;
+            g->period_end = timer_ticks() + period;
+            g->throttled = false;
+            g->consumed_ticks = g->throttled_ticks = g->throttle_cnt = 0;
+            id = i;
+            break;
+        }
+    }
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return id;
+}
+
+/* 현재 프로세스의 모든 스레드를 그룹 ID로 옮깁니다. ID는 현재 그룹이거나 그 자손이어야
+   하므로, 할당량을 벗어나려고 제한이 느슨한 그룹으로 옮겨 갈 수는 없습니다.
+   그런 그룹이 없으면 false를 반환합니다. */
+/* Moves every thread of the running thread's process into group
+   ID, which must be the process's current group or one below
+   it, so a process cannot escape its quota by moving to a looser
+   group.  Returns false if there is no such group. */
+bool thread_group_join(int id) {
+    struct thread *curr = thread_current();
+    struct thread *leader = curr->leader;
+    struct cpu *c = this_cpu();
+    enum intr_level old_level;
+    struct list_elem *e;
+    struct cpu_group *g;
+    bool ok = false;
+
+    if (id < 0 || id >= CPU_GROUP_MAX)
+        return false;
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
+    g = &cpu_groups[id];
+    if (g->ref_cnt != 0 && cpu_group_within(g, curr->cpu_group)) {
+        cpu_group_move(leader, g);
+        for (e = list_begin(&leader->members); e != list_end(&leader->members); e = list_next(e))
+            cpu_group_move(list_entry(e, struct thread, member_elem), g);
+        cpu_group_move(curr, g);
+        ok = true;
+    }
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return ok;
+}
+
+/* 현재 스레드가 속한 그룹의 번호를 반환합니다. */
+/* Returns the id of the running thread's group. */
+int thread_group_current(void) {
+    return thread_current()->cpu_group->id;
+}
+
+/* 그룹 ID가 자손을 포함해 쓴 틱 수와 멈춰 있던 틱 수를 CONSUMED와 THROTTLED에 저장합니다.
+   그룹이 없으면 false를 반환합니다. */
+/* Stores into *CONSUMED the ticks charged to group ID, including
+   its descendants', and into *THROTTLED the ticks it has spent
+   throttled.  Returns false if there is no such group. */
+bool thread_group_usage(int id, long long *consumed, long long *throttled) {
+    struct cpu *c = this_cpu();
+    enum intr_level old_level;
+    struct cpu_group *g;
+    bool ok = false;
+
+    if (id < 0 || id >= CPU_GROUP_MAX)
+        return false;
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->rq_lock);
+    g = &cpu_groups[id];
+    if (g->ref_cnt != 0) {
+        *consumed = g->consumed_ticks;
+        *throttled = g->throttled_ticks;
+        if (g->throttled)
+            *throttled += timer_ticks() - g->throttled_since;
+        ok = true;
+    }
+    spinlock_release(&c->rq_lock);
+    intr_set_level(old_level);
+    return ok;
+}
+
+/* G가 ANCESTOR이거나 그 자손이면 true를 반환합니다. */
+/* Returns true if G is ANCESTOR or lies below it. */
+static bool cpu_group_within(const struct cpu_group *g, const struct cpu_group *ancestor) {
+    for (; g != NULL; g = g->parent)
+        if (g == ancestor)
+            return true;
+    return false;
+}
+
+/* T를 그룹 G로 옮깁니다. T가 예전 그룹에 세워져 있었다면 새 그룹 기준으로 다시
+   준비 큐에 넣습니다. 실행 큐 락을 잡고 있어야 합니다. */
+/* Moves T into group G.  If T was parked on a throttled group,
+   it is queued again under its new group.  The run queue lock
+   must be held. */
+static void cpu_group_move(struct thread *t, struct cpu_group *g) {
+    bool parked = t->parked_on != NULL;
+
+    ASSERT(spinlock_held(&this_cpu()->rq_lock));
+
+    if (t->cpu_group == g)
+        return;
+    if (parked)
+        ready_remove(t);
+    cpu_group_get(g);
+    cpu_group_put(t->cpu_group);
+    t->cpu_group = g;
+    if (parked)
+        ready_push(t);
+}
+
+/* 끝나는 스레드 T가 주 스레드로서 만든 그룹들의 참조를 놓습니다.
+   실행 큐 락을 잡고 있어야 합니다. */
+/* Drops the references held by T, which is exiting, to the
+   groups its process created.  The run queue lock must be
+   held. */
+static void cpu_group_disown(struct thread *t) {
+    ASSERT(spinlock_held(&this_cpu()->rq_lock));
+
+    for (int id = 1; id < CPU_GROUP_MAX; id++) {
+        struct cpu_group *g = &cpu_groups[id];
+
+        if (g->ref_cnt != 0 && g->owner == t) {
+            g->owner = NULL;
+            cpu_group_put(g);
+        }
+    }
+}
+
+/* 살아 있는 그룹마다 사용량을 출력합니다. */
+/* Prints the usage of each live group. */
+static void cpu_group_print_stats(void) {
+    for (int id = 1; id < CPU_GROUP_MAX; id++) {
+        long long consumed, throttled;
+        struct cpu_group *g = &cpu_groups[id];
+
+        if (thread_group_usage(id, &consumed, &throttled))
+            printf("Thread: CPU group %d (%lld/%lld under %d) %lld consumed ticks, %lld throttled ticks in %lld throttles\n",
+                   id, (long long)g->quota, (long long)g->period, g->parent->id,
+                   consumed, throttled, g->throttle_cnt);
+    }
 }
 
 /* 유휴 스레드입니다. 다른 스레드가 실행 준비가 되어 있지 않을 때 실행됩니다.
@@ -564,15 +1730,33 @@ int thread_get_recent_cpu(void) {
 static void idle(void *idle_started_ UNUSED) {
     struct semaphore *idle_started = idle_started_;
 
-    idle_thread = thread_current();
+    this_cpu()->idle_thread = thread_current();
     sema_up(idle_started);
 
     for (;;) {
         /* 다른 사람에게 실행을 양보합니다. */
         /* Let someone else run. */
         intr_disable();
+        timer_idle_exit();
         thread_block();
 
+        /* 할 일이 없는 동안 PAL_ZERO 요청에 쓸 페이지를 한 장씩 미리 지워 둡니다.
+           다른 스레드가 준비되면 곧바로 멈추고 그 스레드를 스케줄합니다. */
+        /* With nothing else to do, zero pages one at a time for
+           PAL_ZERO requests to take later.  Stop as soon as a thread
+           becomes ready, and go schedule it. */
+        intr_enable();
+        while (this_cpu()->ready_cnt == 0 && palloc_prezero())
+            continue;
+        intr_disable();
+        if (this_cpu()->ready_cnt > 0)
+            continue;
+
+        /* 잠든 스레드 말고는 할 일이 없으므로, 다음 마감 시각까지 틱을 멈춥니다. */
+        /* Nothing but sleepers left: stop the periodic tick until
+           the earliest deadline. */
+        timer_idle_enter();
+
         /* 인터럽트를 다시 활성화하고 다음 인터럽트를 기다립니다.
 
             'sti' 명령은 다음 명령의 완료까지 인터럽트를 비활성화하므로,
@@ -592,8 +1776,20 @@ static void idle(void *idle_started_ UNUSED) {
            time.
 
            See [IA32-v2a] "HLT", [IA32-v2b] "STI", and [IA32-v3a]
-           7.11.1 "HLT Instruction". */
-        asm volatile("sti; hlt" : : : "memory");
+           7.11.1 "HLT Instruction".
+
+           원샷을 이어 붙이는 동안에는 중간 원샷이 만료될 때도 깨어나므로,
+           준비된 스레드가 없고 유휴 구간이 끝나지 않았으면 다시 hlt합니다. */
+        /* While one-shots are being chained, each intermediate
+           expiry wakes us as well; halt again if no thread became
+           ready and the idle period is not over. */
+        for (;;) {
+            intr_trace_stop();
+            asm volatile("sti; hlt" : : : "memory");
+            intr_disable();
+            if (this_cpu()->ready_cnt > 0 || !timer_idle_armed())
+                break;
+        }
     }
 }
 
@@ -602,6 +1798,11 @@ static void idle(void *idle_started_ UNUSED) {
 static void kernel_thread(thread_func *function, void *aux) {
     ASSERT(function != NULL);
 
+    /* 처음 스케줄된 스레드는 schedule()의 끝을 거치지 않으므로 여기서 실행 큐 락을 놓습니다. */
+    /* A thread's first run does not pass through the tail of
+       schedule(), so drop the run queue lock here. */
+    spinlock_release(&this_cpu()->rq_lock);
+
     intr_enable(); /* 스케줄러는 인터럽트를 끈 상태에서 실행됩니다. */ /* The scheduler runs with interrupts off. */
     function(aux); /* 스레드 함수를 실행합니다. */                     /* Execute the thread function. */
     thread_exit(); /* function()이 반환하면 스레드를 종료합니다. */    /* If function() returns, kill the thread. */
@@ -611,6 +1812,8 @@ static void kernel_thread(thread_func *function, void *aux) {
 /* Does basic initialization of T as a blocked thread named
    NAME. */
 static void init_thread(struct thread *t, const char *name, int priority) {
+    enum intr_level old_level;
+
     ASSERT(t != NULL);
     ASSERT(PRI_MIN <= priority && priority <= PRI_MAX);
     ASSERT(name != NULL);
@@ -622,15 +1825,24 @@ static void init_thread(struct thread *t, const char *name, int priority) {
     t->priority = priority;
     t->init_priority = priority;
     t->wait_on_lock = NULL;
-    list_init (&t->donations);
+    heap_init(&t->held_locks, held_lock_less, NULL);
+    t->nice = NICE_DEFAULT;
+    t->recent_cpu = 0;
+    t->decay_epoch = decay_epoch;
 
     // project 2: system call
     list_init (&t->child_list);
     sema_init (&t->wait_sema, 0);
     sema_init (&t->free_sema, 0);
     sema_init (&t->fork_sema, 0);
+    t->leader = t;
+    list_init (&t->members);
 
     t->magic = THREAD_MAGIC;
+
+    old_level = intr_disable();
+    list_push_back(&all_list, &t->all_elem);
+    intr_set_level(old_level);
 }
 
 /* 실행할 다음 스레드를 선택하고 반환합니다. 실행 큐에서 스레드를 반환해야 합니다.
@@ -642,15 +1854,132 @@ static void init_thread(struct thread *t, const char *name, int priority) {
    will be in the run queue.)  If the run queue is empty, return
    idle_thread. */
 static struct thread *next_thread_to_run(void) {
-    if (list_empty(&ready_list))
-        return idle_thread;
-    else
-        return list_entry(list_pop_front(&ready_list), struct thread, elem);
+    struct cpu *c = this_cpu();
+    struct thread *t;
+
+    ASSERT(spinlock_held(&c->rq_lock));
+
+    /* 준비 큐에 들어간 뒤 그룹이 멈춘 스레드는 여기서 걸러 냅니다. */
+    /* Threads whose group was throttled after they were queued
+       are parked as they come up. */
+    do
+        t = pick_ready(c);
+    while (t != c->idle_thread && cpu_group_park(t));
+    return t;
+}
+
+/* C의 실행 큐에서 다음 스레드를 꺼내 반환합니다. 비어 있으면 유휴 스레드를 반환합니다. */
+/* Takes the next thread off C's run queue and returns it, or
+   returns the idle thread if the run queue is empty. */
+static struct thread *pick_ready(struct cpu *c) {
+    int pri = ready_max_priority();
+    struct thread *t;
+
+    if (!heap_empty(&c->edf_queue)) {
+        t = heap_entry(heap_pop(&c->edf_queue), struct thread, edf_elem);
+        c->ready_cnt--;
+        return t;
+    }
+    if (thread_cfs) {
+        struct rb_node *first = rb_first(&c->cfs_tree);
+
+        if (first == NULL)
+            return c->idle_thread;
+        t = rb_entry(first, struct thread, cfs_node);
+        ready_remove(t);
+        return t;
+    }
+    if (pri < 0)
+        return c->idle_thread;
+
+    t = list_entry(list_pop_front(&c->ready_queues[pri]), struct thread, elem);
+    if (list_empty(&c->ready_queues[pri]))
+        c->ready_bitmap &= ~(1ULL << pri);
+    c->ready_cnt--;
+    return t;
+}
+
+/* T를 자신의 우선순위 큐 맨 뒤에 넣습니다. T의 그룹이 멈춰 있으면 대신 그 그룹에 세워 둡니다.
+   실행 큐 락을 잡은 상태에서 호출해야 합니다. */
+/* Appends T to the ready queue for its priority, or parks it on
+   its throttled group instead.  The run queue lock must be
+   held. */
+static void ready_push(struct thread *t) {
+    struct cpu *c = this_cpu();
+
+    ASSERT(spinlock_held(&c->rq_lock));
+    ASSERT(PRI_MIN <= t->priority && t->priority <= PRI_MAX);
+
+    if (cpu_group_park(t))
+        return;
+    if (edf_active(t)) {
+        heap_push(&c->edf_queue, &t->edf_elem);
+        c->ready_cnt++;
+        return;
+    }
+    if (thread_cfs) {
+        rb_insert(&c->cfs_tree, &t->cfs_node);
+        c->cfs_weight += cfs_weight(t);
+        c->ready_cnt++;
+        return;
+    }
+    list_push_back(&c->ready_queues[t->priority], &t->elem);
+    c->ready_bitmap |= 1ULL << t->priority;
+    c->ready_cnt++;
+}
+
+/* 준비 큐에서 T를 빼냅니다. T는 현재 우선순위의 큐에 들어 있거나 그룹에 세워져 있어야 합니다. */
+/* Removes T from the ready queue it sits on, which must be the
+   one for its current priority, or from the group it is parked
+   on.  The run queue lock must be held. */
+static void ready_remove(struct thread *t) {
+    struct cpu *c = this_cpu();
+
+    ASSERT(spinlock_held(&c->rq_lock));
+
+    if (t->parked_on != NULL) {
+        list_remove(&t->elem);
+        t->parked_on = NULL;
+        return;
+    }
+    if (edf_active(t)) {
+        heap_remove(&c->edf_queue, &t->edf_elem);
+        c->ready_cnt--;
+        return;
+    }
+    if (thread_cfs) {
+        rb_remove(&c->cfs_tree, &t->cfs_node);
+        c->cfs_weight -= cfs_weight(t);
+        c->ready_cnt--;
+        return;
+    }
+    list_remove(&t->elem);
+    if (list_empty(&c->ready_queues[t->priority]))
+        c->ready_bitmap &= ~(1ULL << t->priority);
+    c->ready_cnt--;
+}
+
+/* 준비된 스레드 중 가장 높은 우선순위를 반환하고, 없으면 -1을 반환합니다.
+   실행 큐 락 없이 호출하면 그 순간의 스냅샷일 뿐입니다. */
+/* Returns the highest priority among ready threads, or -1 if
+   no thread is ready.  Without the run queue lock held this is
+   only a snapshot, which is fine for preemption checks. */
+static int ready_max_priority(void) {
+    uint64_t bitmap = this_cpu()->ready_bitmap;
+
+    if (bitmap == 0)
+        return -1;
+    return 63 - __builtin_clzll(bitmap);
 }
 
 /* iretq를 사용하여 스레드를 시작합니다. */
 /* Use iretq to launch the thread */
 void do_iret(struct intr_frame *tf) {
+    /* iretq가 인터럽트를 켜면 인터럽트가 꺼져 있던 구간을 여기서 닫습니다. */
+    /* If iretq turns interrupts on, the interrupts-off window
+       ends here. */
+    if ((tf->eflags & FLAG_IF) && intr_get_level() == INTR_OFF)
+        intr_trace_stop();
     __asm __volatile(
         "movq %0, %%rsp\n"
         "movq 0(%%rsp),%%r15\n"
@@ -693,68 +2022,23 @@ void do_iret(struct intr_frame *tf) {
    complete.  In practice that means that printf()s should be
    added at the end of the function. */
 static void thread_launch(struct thread *th) {
-    uint64_t tf_cur = (uint64_t)&running_thread()->tf;  // 현재 실행 중인 스레드의 프레임 주소를 가져옵니다.
-    uint64_t tf = (uint64_t)&th->tf;                    // 전환될 새 스레드의 프레임 주소를 가져옵니다.
-    ASSERT(intr_get_level() == INTR_OFF);               // 인터럽트가 비활성화되었는지 확인합니다.
-
-    /* 주 스위칭 로직입니다.
-     * 먼저 전체 실행 컨텍스트를 intr_frame으로 복원하고 do_iret를 호출하여 다음 스레드로 전환합니다.
-     * 여기서 스위칭이 완료될 때까지 스택을 사용해서는 안 됩니다. */
-    /* The main switching logic.
-     * We first restore the whole execution context into the intr_frame
-     * and then switching to the next thread by calling do_iret.
-     * Note that, we SHOULD NOT use any stack from here
-     * until switching is done. */
-    __asm __volatile(
-        /* 사용될 레지스터를 저장합니다. */ 
-        /* Store registers that will be used. */
-        // 레지스터에 저장된 값을 스택에 밀어넣기
-        "push %%rax\n"
-        "push %%rbx\n"
-        "push %%rcx\n"
-        /* 입력을 한 번만 가져옵니다. */
-        /* Fetch input once */
-        "movq %0, %%rax\n"
-        "movq %1, %%rcx\n"
-        "movq %%r15, 0(%%rax)\n"
-        "movq %%r14, 8(%%rax)\n"
-        "movq %%r13, 16(%%rax)\n"
-        "movq %%r12, 24(%%rax)\n"
-        "movq %%r11, 32(%%rax)\n"
-        "movq %%r10, 40(%%rax)\n"
-        "movq %%r9, 48(%%rax)\n"
-        "movq %%r8, 56(%%rax)\n"
-        "movq %%rsi, 64(%%rax)\n"
-        "movq %%rdi, 72(%%rax)\n"
-        "movq %%rbp, 80(%%rax)\n"
-        "movq %%rdx, 88(%%rax)\n"
-        "pop %%rbx\n"  // Saved rcx
-        "movq %%rbx, 96(%%rax)\n"
-        "pop %%rbx\n"  // Saved rbx
-        "movq %%rbx, 104(%%rax)\n"
-        "pop %%rbx\n"  // Saved rax
-        "movq %%rbx, 112(%%rax)\n"
-        "addq $120, %%rax\n"
-        "movw %%es, (%%rax)\n"
-        "movw %%ds, 8(%%rax)\n"
-        "addq $32, %%rax\n"
-        "call __next\n"  // read the current rip.
-        "__next:\n"
-        "pop %%rbx\n"
-        "addq $(out_iret -  __next), %%rbx\n"
-        "movq %%rbx, 0(%%rax)\n"  // rip
-        "movw %%cs, 8(%%rax)\n"   // cs
-        "pushfq\n"
-        "popq %%rbx\n"
-        "mov %%rbx, 16(%%rax)\n"  // eflags
-        "mov %%rsp, 24(%%rax)\n"  // rsp
-        "movw %%ss, 32(%%rax)\n"
-        "mov %%rcx, %%rdi\n"
-        "call do_iret\n"
-        "out_iret:\n"
-        :
-        : "g"(tf_cur), "g"(tf)
-        : "memory");
+    struct thread *curr = running_thread();
+    ASSERT(intr_get_level() == INTR_OFF);  // 인터럽트가 비활성화되었는지 확인합니다.
+
+    /* 커널 안에서의 전환은 호출 규약상 보존되어야 하는 레지스터와 스택 포인터만
+     * 저장하면 충분합니다. 한 번도 실행되지 않은 스레드만 intr_frame과
+     * do_iret으로 진입합니다. */
+    /* A switch between kernel contexts only has to preserve the
+     * callee-saved registers and the stack pointer, which
+     * switch_threads() does with a plain `ret' at the end.  A
+     * thread that has never run has no saved context yet, so it is
+     * entered through its initial intr_frame and do_iret instead.
+     * Either way, the context of CURR is saved in its switch_rsp
+     * and it resumes by returning from this function. */
+    if (th->switch_rsp != 0)
+        switch_threads(&curr->switch_rsp, th->switch_rsp);
+    else
+        switch_entry(&curr->switch_rsp, &th->tf);
 }
 
 /* 새 프로세스를 스케줄링합니다. 진입 시, 인터럽트는 꺼져 있어야 합니다.
@@ -766,13 +2050,26 @@ static void thread_launch(struct thread *th) {
  * finds another thread to run and switches to it.
  * It's not safe to call printf() in the schedule(). */
 static void do_schedule(int status) {
+    struct cpu *c = this_cpu();
+    struct thread *curr = thread_current();
+
     ASSERT(intr_get_level() == INTR_OFF);
-    ASSERT(thread_current()->status == THREAD_RUNNING);
-    while (!list_empty(&destruction_req)) {
-        struct thread *victim = list_entry(list_pop_front(&destruction_req), struct thread, elem);
-        palloc_free_page(victim);
+    ASSERT(curr->status == THREAD_RUNNING);
+
+    /* palloc은 풀의 락을 잡으므로 실행 큐 락을 잡기 전에 해제합니다. */
+    /* palloc takes its pool's lock, so reap before taking the run
+       queue lock. */
+    while (!list_empty(&c->destruction_req)) {
+        struct thread *victim = list_entry(list_pop_front(&c->destruction_req), struct thread, elem);
+        obj_cache_put(&thread_cache, victim);
     }
-    thread_current()->status = status;
+
+    spinlock_acquire(&c->rq_lock);
+    if (status == THREAD_READY && curr != c->idle_thread) {
+        ready_push(curr);
+        sched_trace_ready(curr);
+    }
+    curr->status = status;
     schedule();
 }
 
@@ -781,20 +2078,40 @@ static void do_schedule(int status) {
    이 함수의 호출은 현재 실행 중인 스레드의 상태가 '실행 중'이 아니라고 가정합니다.
    또한, 다음에 실행될 스레드가 유효한 스레드 객체인지 확인합니다. */
 static void schedule(void) {
+    struct cpu *c = this_cpu();
     struct thread *curr = running_thread();      // 현재 실행 중인 스레드를 가져옵니다.
     struct thread *next = next_thread_to_run();  // 다음에 실행할 스레드를 결정합니다.
 
     ASSERT(intr_get_level() == INTR_OFF);    // 인터럽트가 비활성화되었는지 확인합니다.
+    ASSERT(spinlock_held(&c->rq_lock));      // 실행 큐 락을 잡고 있는지 확인합니다.
     ASSERT(curr->status != THREAD_RUNNING);  // 현재 스레드의 상태가 실행 중이 아닌지 확인합니다.
     ASSERT(is_thread(next));                 // 다음 스레드가 유효한 스레드인지 확인합니다.
 
+    if (curr->status == THREAD_BLOCKED)
+        sched_trace(SCHED_EV_BLOCK, curr, NULL, curr->priority);
+    else if (curr->status == THREAD_READY)
+        sched_trace(SCHED_EV_YIELD, curr, NULL, curr->priority);
+    if (curr != next) {
+        sched_trace(SCHED_EV_SWITCH, curr, next, next->priority);
+        /* 잠들면 자발적, 실행 가능한 채로 밀려나면 비자발적 전환입니다. */
+        /* Blocking is a voluntary switch; giving up the CPU while
+           still runnable is an involuntary one. */
+        if (curr->status == THREAD_BLOCKED)
+            curr->rusage.nvcsw++;
+        else if (curr->status == THREAD_READY)
+            curr->rusage.nivcsw++;
+    }
+    sched_trace_run(next);
+
     /* 다음 스레드의 상태를 '실행 중'으로 설정합니다. */
     /* Mark us as running. */
     next->status = THREAD_RUNNING;
 
     /* 새로운 시간 할당량을 시작합니다. */
     /* Start new time slice. */
-    thread_ticks = 0;
+    c->thread_ticks = 0;
+    if (thread_cfs)
+        c->slice = cfs_slice(c, next);
 
 #ifdef USERPROG
     /* 새로운 주소 공간을 활성화합니다. */
@@ -815,7 +2132,7 @@ static void schedule(void) {
            schedule(). */
         if (curr && curr->status == THREAD_DYING && curr != initial_thread) {
             ASSERT(curr != next);
-            list_push_back(&destruction_req, &curr->elem);
+            list_push_back(&c->destruction_req, &curr->elem);
         }
 
         /* 전환할 스레드를 선택한 후, 우리는 먼저 현재 실행 중인 스레드의 정보를 저장합니다. */
@@ -823,6 +2140,11 @@ static void schedule(void) {
          * of current running. */
         thread_launch(next);
     }
+
+    /* 여기는 전환되어 돌아온 스레드의 문맥입니다. 실행 큐 락을 놓습니다. */
+    /* We are now running in the context of the thread switched
+       to.  Release the run queue lock it inherited. */
+    spinlock_release(&this_cpu()->rq_lock);
 }
 
 /* 새 스레드를 위한 tid를 반환합니다. */
@@ -838,43 +2160,160 @@ static tid_t allocate_tid(void) {
     return tid;
 }
 
-bool thread_compare_donate_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-	return list_entry(e1,struct thread,donation_elem)->priority > list_entry(e2,struct thread, donation_elem)->priority;
+/* 기부자 힙의 비교 함수입니다. 우선순위가 높은 스레드가 먼저 나옵니다. */
+/* Orders a lock's donors heap so that the highest-priority
+   waiter is on top. */
+bool thread_donor_less(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED) {
+    return heap_entry(a, struct thread, donor_elem)->priority > heap_entry(b, struct thread, donor_elem)->priority;
+}
+
+/* LOCK을 기다리는 스레드 중 가장 높은 우선순위, 없으면 PRI_MIN - 1을 반환합니다. */
+/* Returns the highest priority among the threads waiting for
+   LOCK, or PRI_MIN - 1 if there are none. */
+static int lock_priority(const struct lock *lock) {
+    struct heap_elem *top = heap_top(&lock->donors);
+
+    return top != NULL ? heap_entry(top, struct thread, donor_elem)->priority : PRI_MIN - 1;
+}
+
+/* Orders a thread's held_locks heap so that the lock with the
+   highest-priority waiter is on top. */
+static bool held_lock_less(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED) {
+    return lock_priority(heap_entry(a, struct lock, holder_elem)) > lock_priority(heap_entry(b, struct lock, holder_elem));
 }
 
+/* 현재 스레드가 기다리는 락의 사슬을 따라 우선순위를 기부합니다.
+   깊이 제한은 없으며, 이미 충분히 높은 보유자를 만나면 멈춥니다. */
+/* Donates the current thread's priority along the chain of
+   locks it is waiting for.  The current thread must already be
+   in its wait_on_lock's donors heap.  Every thread whose
+   priority rises is repositioned in the donors heap of the lock
+   it waits for in turn, and every lock on the chain in its
+   holder's held_locks heap.  There is no depth limit; the walk
+   stops at the first holder that already runs at least at the
+   donated priority, since nothing beyond it can change.
+   Interrupts must be off. */
 void donate_priority(void) {
+    struct thread *t = thread_current();
 
-    int depth;
-    struct thread *curr = thread_current();
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    while (t->wait_on_lock != NULL) {
+        struct lock *lock = t->wait_on_lock;
+        struct thread *holder = lock->holder;
 
-    for (depth = 0; depth < 8 ; depth++) {
-        if(!curr->wait_on_lock) 
+        if (holder == NULL)
+            break;
+        heap_update(&holder->held_locks, &lock->holder_elem);
+        if (holder->priority >= t->priority)
             break;
-        struct thread *holder = curr->wait_on_lock->holder;
-        holder->priority = curr->priority;
-        curr = holder;
+        thread_update_priority(holder, t->priority);
+
+        t = holder;
+        if (t->wait_on_lock != NULL)
+            heap_update(&t->wait_on_lock->donors, &t->donor_elem);
     }
 }
 
-void remove_with_lock(struct lock *lock) {
-    struct list_elem *e;
+/* 현재 스레드의 우선순위를 원래 우선순위와 보유한 락의 기부 중 큰 값으로 다시 계산합니다. */
+/* Recomputes the current thread's priority as the larger of its
+   own priority and the best donation among the locks it still
+   holds.  Only the top of held_locks is consulted. */
+void refresh_priority(void) {
     struct thread *curr = thread_current();
-
-    for (e = list_begin(&curr->donations); e != list_end(&curr->donations); e = list_next(e)) {
-        struct thread *t = list_entry(e, struct thread, donation_elem);
-        if (t->wait_on_lock == lock) 
-            list_remove(&t->donation_elem);
+    enum intr_level old_level = intr_disable();
+    struct heap_elem *top = heap_top(&curr->held_locks);
+    int priority = curr->init_priority;
+
+    if (top != NULL) {
+        int donated = lock_priority(heap_entry(top, struct lock, holder_elem));
+        if (donated > priority)
+            priority = donated;
     }
+    thread_update_priority(curr, priority);
+    intr_set_level(old_level);
 }
 
-void refresh_priority(void) {
-    struct thread *curr = thread_current();
-    curr->priority = curr->init_priority;
-    
-    if (!list_empty(&curr->donations)) {
-        list_sort(&curr->donations, thread_compare_donate_priority, NULL);
-        struct thread *front = list_entry(list_front(&curr->donations), struct thread, donation_elem);
-        if (front->priority > curr->priority)
-            curr->priority = front->priority;
+/* T의 fdt 페이지를 캐시에 반환합니다. 사용한 적 있는 범위(fd_idx까지)만 지웁니다. */
+/* Returns T's fdt page to the cache.  Only the slots T could
+   have used, up to its fd_idx high-water mark, are cleared. */
+void thread_fdt_free(struct thread *t) {
+    int used = t->fd_idx + 1;
+
+    if (t->fdt == NULL)
+        return;
+    if (used > FDT_COUNT_LIMIT)
+        used = FDT_COUNT_LIMIT;
+    memset(t->fdt, 0, used * sizeof *t->fdt);
+    obj_cache_put(&fdt_cache, t->fdt);
+    t->fdt = NULL;
+}
+
+/* 빈 캐시 C를 초기화합니다. 캐시가 비면 MISS_FLAGS로 palloc합니다. */
+/* Initializes C as an empty cache named NAME that falls back to
+   palloc_get_page(MISS_FLAGS) when empty. */
+static void obj_cache_init(struct obj_cache *c, const char *name, enum palloc_flags miss_flags) {
+    c->name = name;
+    spinlock_init(&c->lock, name);
+    list_init(&c->pages);
+    c->page_cnt = 0;
+    c->miss_flags = miss_flags;
+    c->hits = c->misses = 0;
+}
+
+/* C에서 페이지 하나를 꺼냅니다. 비어 있으면 palloc으로 할당하고, 실패하면 NULL. */
+/* Takes a page from C, or allocates one from palloc if C is
+   empty.  Returns a null pointer if memory is exhausted. */
+static void *obj_cache_get(struct obj_cache *c) {
+    struct list_elem *e = NULL;
+    enum intr_level old_level;
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->lock);
+    if (!list_empty(&c->pages)) {
+        e = list_pop_front(&c->pages);
+        c->page_cnt--;
+        c->hits++;
+    } else
+        c->misses++;
+    spinlock_release(&c->lock);
+    intr_set_level(old_level);
+
+    if (e == NULL)
+        return palloc_get_page(c->miss_flags);
+
+    /* 연결에 쓰인 list_elem 자리만 지웁니다. */
+    /* Clear only the bytes the link used. */
+    memset(e, 0, sizeof *e);
+    return e;
+}
+
+/* PAGE를 C에 반환합니다. 캐시가 가득 찼으면 페이지 풀로 돌려보냅니다.
+   인터럽트가 꺼진 상태에서도 호출할 수 있습니다. */
+/* Returns PAGE to C, or to the page pool if C is full.  May be
+   called with interrupts off. */
+static void obj_cache_put(struct obj_cache *c, void *page) {
+    enum intr_level old_level;
+    bool cached = false;
+
+    ASSERT(pg_ofs(page) == 0);
+
+    old_level = intr_disable();
+    spinlock_acquire(&c->lock);
+    if (c->page_cnt < OBJ_CACHE_MAX) {
+        list_push_front(&c->pages, (struct list_elem *)page);
+        c->page_cnt++;
+        cached = true;
     }
-}
\ No newline at end of file
+    spinlock_release(&c->lock);
+    intr_set_level(old_level);
+
+    if (!cached)
+        palloc_free_page(page);
+}
+
+/* C의 통계를 출력합니다. */
+/* Prints statistics for C. */
+static void obj_cache_print_stats(struct obj_cache *c) {
+    printf("Thread: %s cache %lld hits, %lld misses, %zu pages cached\n", c->name, c->hits, c->misses, c->page_cnt);
+}
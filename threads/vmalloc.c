@@ -0,0 +1,226 @@
+#include "threads/vmalloc.h"
+
+#include <bitmap.h>
+#include <debug.h>
+#include <round.h>
+#include <stdio.h>
+
+#include "intrinsic.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/mmu.h"
+#include "threads/palloc.h"
+#include "threads/pte.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+/* 해제되었지만 TLB를 아직 비우지 않은 범위의 최대 수. */
+/* Most ranges freed but not yet flushed from the TLB. */
+#define VMALLOC_LAZY_MAX 32
+
+/* 영역 안의 페이지 범위. */
+/* A range of pages within the area. */
+struct vm_range {
+    size_t start;               /* 첫 페이지의 번호. *//* Index of first page. */
+    size_t cnt;                 /* 페이지 수. *//* Number of pages. */
+};
+
+/* 아래 변수들을 보호합니다. 영역의 페이지 테이블을 만드는 일도 이 락 아래에서 합니다. */
+/* Protects the variables below.  Page tables for the area are
+   also created under it. */
+static struct spinlock vmalloc_lock;
+
+/* 영역에서 쓰이는 페이지. 매핑된 페이지뿐 아니라 각 범위 뒤의 보호 페이지와,
+   해제되었지만 아직 TLB를 비우지 않은 범위도 포함합니다. */
+/* Pages of the area in use: those mapped, plus the guard page
+   after each range and ranges freed but not yet flushed. */
+static struct bitmap *used_map;
+
+/* 해제되었지만 TLB를 아직 비우지 않은 범위. 그 가상 주소는 flush_lazy() 뒤에야
+   다시 씁니다. */
+/* Ranges freed but not yet flushed from the TLB.  Their virtual
+   addresses are not reused until flush_lazy(). */
+static struct vm_range lazy[VMALLOC_LAZY_MAX];
+static size_t lazy_cnt;
+
+/* 통계. */
+/* Statistics. */
+static long long alloc_cnt;     /* 예약한 범위 수. *//* # of ranges reserved. */
+static long long free_cnt;      /* 해제한 범위 수. *//* # of ranges released. */
+static long long flush_cnt;     /* TLB를 비운 횟수. *//* # of TLB flushes. */
+static size_t mapped_cnt;       /* 매핑된 페이지 수. *//* Pages mapped now. */
+
+static uint64_t *area_pte(size_t page_idx, bool create);
+static void area_release(size_t start, size_t mapped, size_t reserved);
+static void flush_lazy(void);
+
+/* vmalloc() 영역을 초기화합니다. MEM_END는 직접 매핑되는 물리 메모리의 끝입니다.
+   paging_init() 이후에 호출해야 합니다. */
+/* Initializes the vmalloc() area.  MEM_END is the end of the
+   directly mapped physical memory.  Must be called after
+   paging_init(). */
+void vmalloc_init(uint64_t mem_end) {
+    size_t bm_size = bitmap_buf_size(VMALLOC_PAGES);
+
+    /* 영역의 페이지 테이블은 모든 pml4가 복사해 가진 커널 PML4 항목 아래에
+       만들어지므로, 나중에 만든 매핑도 모든 주소 공간에 보입니다. */
+    /* The area's page tables hang off the kernel PML4 entry that
+       pml4_create() copies into every pml4, so mappings made
+       later show up in all address spaces. */
+    ASSERT((uint64_t)ptov(mem_end) <= VMALLOC_BASE);
+    ASSERT(PML4(VMALLOC_BASE) == PML4(KERN_BASE));
+    ASSERT(PML4(VMALLOC_END - 1) == PML4(KERN_BASE));
+
+    spinlock_init(&vmalloc_lock, "vmalloc");
+    used_map = bitmap_create_in_buf(VMALLOC_PAGES,
+                                    palloc_get_multiple(PAL_ASSERT, DIV_ROUND_UP(bm_size, PGSIZE)),
+                                    bm_size);
+}
+
+/* 물리적으로 흩어져 있을 수 있는 PAGE_CNT개의 페이지를 연속된 커널 가상 주소에
+   매핑하여 그 시작 주소를 반환합니다. 메모리나 주소 공간이 모자라면 NULL을 반환합니다.
+   페이지 내용은 초기화되지 않습니다. */
+/* Maps PAGE_CNT pages, possibly scattered in physical memory,
+   at contiguous kernel virtual addresses and returns the first.
+   Returns a null pointer if memory or address space runs out.
+   The pages' contents are uninitialized. */
+void *vmalloc(size_t page_cnt) {
+    enum intr_level old_level;
+    size_t start, i;
+
+    if (used_map == NULL || page_cnt == 0 || page_cnt >= VMALLOC_PAGES)
+        return NULL;
+
+    /* 범위 뒤에 매핑하지 않는 보호 페이지를 하나 둡니다. 넘친 접근은 페이지 폴트가
+       되고, vfree()는 여기서 범위가 끝남을 압니다. */
+    /* Leave an unmapped guard page after the range.  Overruns
+       fault, and vfree() finds the end of the range there. */
+    old_level = intr_disable();
+    spinlock_acquire(&vmalloc_lock);
+    start = bitmap_scan_and_flip(used_map, 0, page_cnt + 1, false);
+    if (start == BITMAP_ERROR && lazy_cnt > 0) {
+        flush_lazy();
+        start = bitmap_scan_and_flip(used_map, 0, page_cnt + 1, false);
+    }
+    if (start != BITMAP_ERROR)
+        alloc_cnt++;
+    spinlock_release(&vmalloc_lock);
+    intr_set_level(old_level);
+    if (start == BITMAP_ERROR)
+        return NULL;
+
+    for (i = 0; i < page_cnt; i++) {
+        void *kpage = palloc_get_page(0);
+        uint64_t *pte = NULL;
+
+        if (kpage != NULL) {
+            old_level = intr_disable();
+            spinlock_acquire(&vmalloc_lock);
+            pte = area_pte(start + i, true);
+            if (pte != NULL) {
+                *pte = vtop(kpage) | PTE_P | PTE_W;
+                mapped_cnt++;
+            }
+            spinlock_release(&vmalloc_lock);
+            intr_set_level(old_level);
+        }
+        if (pte == NULL) {
+            if (kpage != NULL)
+                palloc_free_page(kpage);
+            area_release(start, i, page_cnt + 1);
+            return NULL;
+        }
+    }
+    return (void *)(VMALLOC_BASE + start * PGSIZE);
+}
+
+/* vmalloc()이 반환한 P의 매핑을 지우고 페이지를 해제합니다. */
+/* Unmaps and frees P, which vmalloc() returned. */
+void vfree(void *p) {
+    size_t start, cnt;
+    uint64_t *pte;
+
+    if (p == NULL)
+        return;
+    ASSERT(is_vmalloc_vaddr(p) && pg_ofs(p) == 0);
+
+    /* 보호 페이지까지 셉니다. 이 범위의 PTE는 우리만 바꿉니다. */
+    /* Count up to the guard page.  Only we change this range's
+       PTEs. */
+    start = ((uint64_t)p - VMALLOC_BASE) / PGSIZE;
+    for (cnt = 0; (pte = area_pte(start + cnt, false)) != NULL && (*pte & PTE_P); cnt++)
+        continue;
+    ASSERT(cnt > 0);
+    area_release(start, cnt, cnt + 1);
+}
+
+/* vmalloc() 통계를 출력합니다. */
+/* Prints vmalloc() statistics. */
+void vmalloc_print_stats(void) {
+    printf("Vmalloc: %lld allocs, %lld frees, %zu pages mapped, %lld TLB flushes\n", alloc_cnt,
+           free_cnt, mapped_cnt, flush_cnt);
+}
+
+/* 영역의 PAGE_IDX번째 페이지의 PTE를 반환합니다. CREATE이면 필요한 페이지 테이블을
+   만들고, 실패하면 NULL. CREATE이면 vmalloc_lock을 잡고 있어야 합니다. */
+/* Returns the PTE for page PAGE_IDX of the area, creating page
+   tables as needed if CREATE, or a null pointer.  If CREATE,
+   vmalloc_lock must be held. */
+static uint64_t *area_pte(size_t page_idx, bool create) {
+    ASSERT(!create || spinlock_held(&vmalloc_lock));
+    ASSERT(page_idx < VMALLOC_PAGES);
+
+    return pml4e_walk(base_pml4, VMALLOC_BASE + page_idx * PGSIZE, create);
+}
+
+/* START부터 RESERVED개의 페이지를 차지한 범위를 해제합니다. 앞의 MAPPED개는 매핑된
+   페이지입니다. 매핑은 바로 지우고 페이지는 해제하지만, TLB는 비우지 않고 범위를
+   지연 목록에 올립니다. 오래된 TLB 항목은 해제된 메모리에 접근하는 버그만 쓸 수
+   있습니다. */
+/* Releases the range of RESERVED pages at START, the first
+   MAPPED of which are mapped.  The mappings are cleared and the
+   pages freed right away, but the TLB is left alone and the
+   range goes on the lazy list instead.  Only a use-after-free
+   bug could make use of a stale TLB entry. */
+static void area_release(size_t start, size_t mapped, size_t reserved) {
+    enum intr_level old_level;
+    size_t i;
+
+    for (i = 0; i < mapped; i++) {
+        uint64_t *pte = area_pte(start + i, false);
+        void *kpage = ptov(PTE_ADDR(*pte));
+
+        ASSERT(*pte & PTE_P);
+        *pte = 0;
+        palloc_free_page(kpage);
+    }
+
+    old_level = intr_disable();
+    spinlock_acquire(&vmalloc_lock);
+    mapped_cnt -= mapped;
+    free_cnt++;
+    if (lazy_cnt == VMALLOC_LAZY_MAX)
+        flush_lazy();
+    lazy[lazy_cnt].start = start;
+    lazy[lazy_cnt].cnt = reserved;
+    lazy_cnt++;
+    spinlock_release(&vmalloc_lock);
+    intr_set_level(old_level);
+}
+
+/* TLB를 비우고 지연 목록의 범위들을 다시 쓸 수 있게 합니다. vmalloc_lock을 잡고
+   있어야 합니다. CPU가 여럿이 되면 다른 CPU의 TLB도 비워야 합니다. */
+/* Flushes the TLB and makes the ranges on the lazy list
+   available again.  vmalloc_lock must be held.  With more than
+   one CPU, the other CPUs' TLBs would need flushing too. */
+static void flush_lazy(void) {
+    size_t i;
+
+    ASSERT(spinlock_held(&vmalloc_lock));
+
+    lcr3(rcr3());
+    for (i = 0; i < lazy_cnt; i++)
+        bitmap_set_multiple(used_map, lazy[i].start, lazy[i].cnt, false);
+    lazy_cnt = 0;
+    flush_cnt++;
+}
@@ -188,6 +188,7 @@ page_fault (struct intr_frame *f) {
 	not_present = (f->error_code & PF_P) == 0;
 	write = (f->error_code & PF_W) != 0;
 	user = (f->error_code & PF_U) != 0;
+	thread_current ()->rusage.page_faults++;
 
 #ifdef VM
 	/* 프로젝트 3부터 사용됩니다. */
@@ -0,0 +1,223 @@
+#include "userprog/futex.h"
+
+#include <debug.h>
+#include <hash.h>
+#include <list.h>
+#include <stdbool.h>
+
+#include "devices/timer.h"
+#include "threads/interrupt.h"
+#include "threads/mmu.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "userprog/process.h"
+
+/* 해시 테이블의 버킷 수. 2의 거듭제곱이어야 합니다. */
+/* Number of hash table buckets.  Must be a power of 2. */
+#define FUTEX_BUCKETS 64
+
+/* futex_sleep()에서 잠든 스레드. 그 스레드의 스택에 있습니다. */
+/* A thread asleep in futex_sleep().  Lives on that thread's
+   stack. */
+struct futex_waiter {
+    struct list_elem elem;      /* 버킷의 waiters 요소. *//* Element in bucket's waiters. */
+    struct thread *thread;      /* 잠든 스레드. *//* The sleeping thread. */
+    const void *as;             /* 키: 주소 공간 (pml4). *//* Key: address space (pml4). */
+    const int *uaddr;           /* 키: 사용자 가상 주소. *//* Key: user virtual address. */
+    bool woken;                 /* futex_wakeup()이 깨웠는가? *//* Woken by futex_wakeup()? */
+};
+
+/* (주소 공간, 사용자 주소) 키가 같은 버킷으로 모이는 대기자들. GUARD가 목록과,
+   잠들기 전에 값을 확인하는 일을 함께 보호하므로 값을 바꾸고 깨우는 쪽과
+   어긋나지 않습니다. */
+/* Waiters whose (address space, user address) keys hash to the
+   same bucket.  GUARD protects the list, and also covers the
+   check of the value before going to sleep, so no wake up can
+   slip in between the check and the sleep. */
+struct futex_bucket {
+    struct spinlock guard;
+    struct list waiters;
+};
+
+static struct futex_bucket buckets[FUTEX_BUCKETS];
+
+static struct futex_bucket *bucket_of(const void *as, const int *uaddr);
+static bool waiter_higher(const struct list_elem *, const struct list_elem *, void *aux);
+
+/* futex 해시 테이블을 초기화합니다. */
+/* Initializes the futex hash table. */
+void futex_init(void) {
+    size_t i;
+
+    for (i = 0; i < FUTEX_BUCKETS; i++) {
+        spinlock_init(&buckets[i].guard, "futex");
+        list_init(&buckets[i].waiters);
+    }
+}
+
+/* *UADDR가 EXPECTED이면 futex_wakeup()이 깨우거나 TIMEOUT 틱이 지날 때까지
+   잠듭니다. TIMEOUT이 0이면 시간 제한 없이 기다립니다. UADDR는 검증된, 4바이트
+   정렬된 사용자 주소여야 합니다. FUTEX_WOKEN, FUTEX_CHANGED, FUTEX_TIMEDOUT 중
+   하나를 반환합니다. */
+/* If *UADDR holds EXPECTED, sleeps until futex_wakeup() wakes
+   us up or TIMEOUT ticks pass; a TIMEOUT of 0 waits forever.
+   UADDR must be a validated, 4-byte aligned user address.
+   Returns FUTEX_WOKEN, FUTEX_CHANGED or FUTEX_TIMEDOUT. */
+int futex_sleep(int *uaddr, int expected, int64_t timeout) {
+    struct thread *curr = thread_current();
+    struct futex_bucket *b = bucket_of(curr->pml4, uaddr);
+    struct futex_waiter w;
+    enum intr_level old_level;
+    const int *kaddr;
+    int result;
+
+    ASSERT(timeout >= 0);
+
+    w.thread = curr;
+    w.as = curr->pml4;
+    w.uaddr = uaddr;
+    w.woken = false;
+
+    old_level = intr_disable();
+    spinlock_acquire(&b->guard);
+
+    /* 인터럽트가 꺼진 채로는 페이지 폴트를 처리할 수 없으므로 커널 주소로 읽습니다.
+       그새 페이지가 빠졌다면 값이 바뀐 것으로 답합니다. 호출자는 어차피 다시 확인합니다.
+       프로세스가 끝나는 중이면 futex_release()가 이미 지나갔을 수 있으므로 잠들지 않습니다. */
+    /* A page fault cannot be handled with interrupts off, so
+       read through the kernel mapping.  If the page went away
+       meanwhile, report a change: callers check again anyway.
+       Nor do we sleep once the process is exiting, as
+       futex_release() may already have gone by. */
+    kaddr = pml4_get_page(curr->pml4, uaddr);
+    if (kaddr == NULL || *kaddr != expected || process_exiting()) {
+        spinlock_release(&b->guard);
+        intr_set_level(old_level);
+        return FUTEX_CHANGED;
+    }
+
+    list_push_back(&b->waiters, &w.elem);
+    thread_sleep_on(&b->guard, timeout > 0 ? timer_ticks() + timeout : INT64_MAX);
+
+    /* 깨운 쪽이 이미 목록에서 뺐거나, 시간이 다 되어 스스로 빠져야 합니다. */
+    /* Either our waker took us off the list, or the timeout ran
+       out and we must take ourselves off. */
+    spinlock_acquire(&b->guard);
+    if (w.woken)
+        result = FUTEX_WOKEN;
+    else {
+        list_remove(&w.elem);
+        result = FUTEX_TIMEDOUT;
+    }
+    spinlock_release(&b->guard);
+    intr_set_level(old_level);
+    return result;
+}
+
+/* 현재 주소 공간에서 UADDR에 잠든 스레드를 우선순위가 높은 순서로 최대 N개
+   깨우고, 깨운 수를 반환합니다. 우선순위가 같으면 먼저 잠든 스레드가 먼저입니다. */
+/* Wakes up to N threads asleep on UADDR in the current address
+   space, highest priority first, and returns how many it woke.
+   Among equals, the earliest sleeper goes first. */
+int futex_wakeup(int *uaddr, int n) {
+    const void *as = thread_current()->pml4;
+    struct futex_bucket *b = bucket_of(as, uaddr);
+    enum intr_level old_level;
+    struct list matched;
+    struct list_elem *e;
+    int cnt = 0, woken = 0;
+
+    list_init(&matched);
+    old_level = intr_disable();
+    spinlock_acquire(&b->guard);
+
+    /* 버킷을 한 번만 훑으며 키가 맞는 대기자를 모두 떼어 냅니다. 다 깨우지 않을
+       때만 우선순위로 (안정) 정렬하고, 깨우지 않은 대기자는 버킷에 돌려놓습니다. */
+    /* Take every waiter on our key off the bucket in one pass.
+       Only if they are not all to be woken are they sorted, by
+       priority (list_sort() is stable, so the earliest sleeper
+       still goes first among equals), and the rest go back. */
+    e = list_begin(&b->waiters);
+    while (e != list_end(&b->waiters)) {
+        struct futex_waiter *w = list_entry(e, struct futex_waiter, elem);
+
+        e = list_next(e);
+        if (w->as == as && w->uaddr == uaddr) {
+            list_remove(&w->elem);
+            list_push_back(&matched, &w->elem);
+            cnt++;
+        }
+    }
+    if (cnt > n)
+        list_sort(&matched, waiter_higher, NULL);
+    while (!list_empty(&matched)) {
+        struct futex_waiter *w = list_entry(list_pop_front(&matched), struct futex_waiter, elem);
+
+        if (woken < n) {
+            w->woken = true;
+            thread_wake_sleeper(w->thread);
+            woken++;
+        } else
+            list_push_back(&b->waiters, &w->elem);
+    }
+    spinlock_release(&b->guard);
+    intr_set_level(old_level);
+
+    /* 더 높은 우선순위의 스레드를 깨웠다면 양보합니다. */
+    /* Yield if we woke up a higher-priority thread. */
+    if (woken > 0)
+        test_max_priority();
+    return woken;
+}
+
+/* 주소 공간 AS에서 잠든 스레드를 모두 깨웁니다. 프로세스가 끝날 때, 그 스레드들이
+   사용자 모드로 돌아가며 끝나도록 부릅니다. 버킷마다 GUARD를 잡으므로 그 뒤에 잠들려는
+   스레드는 process_exiting()을 보고 잠들지 않습니다. */
+/* Wakes up every thread asleep in address space AS.  Called as
+   a process exits, so that its threads head back towards user
+   mode and end there.  Each bucket's GUARD is taken in turn,
+   so a thread that tries to sleep afterward sees
+   process_exiting() and does not. */
+void futex_release(const void *as) {
+    enum intr_level old_level;
+    size_t i;
+
+    old_level = intr_disable();
+    for (i = 0; i < FUTEX_BUCKETS; i++) {
+        struct futex_bucket *b = &buckets[i];
+        struct list_elem *e;
+
+        spinlock_acquire(&b->guard);
+        e = list_begin(&b->waiters);
+        while (e != list_end(&b->waiters)) {
+            struct futex_waiter *w = list_entry(e, struct futex_waiter, elem);
+
+            e = list_next(e);
+            if (w->as == as) {
+                list_remove(&w->elem);
+                w->woken = true;
+                thread_wake_sleeper(w->thread);
+            }
+        }
+        spinlock_release(&b->guard);
+    }
+    intr_set_level(old_level);
+}
+
+/* AS와 UADDR 키의 버킷을 반환합니다. */
+/* Returns the bucket for key AS, UADDR. */
+static struct futex_bucket *bucket_of(const void *as, const int *uaddr) {
+    uintptr_t key[2] = {(uintptr_t)as, (uintptr_t)uaddr};
+
+    return &buckets[hash_bytes(key, sizeof key) & (FUTEX_BUCKETS - 1)];
+}
+
+/* 우선순위가 높은 대기자가 앞서도록 두 대기자를 비교합니다. */
+/* Orders waiters highest priority first. */
+static bool waiter_higher(const struct list_elem *a_, const struct list_elem *b_, void *aux UNUSED) {
+    const struct futex_waiter *a = list_entry(a_, struct futex_waiter, elem);
+    const struct futex_waiter *b = list_entry(b_, struct futex_waiter, elem);
+
+    return a->thread->priority > b->thread->priority;
+}
@@ -19,6 +19,7 @@
 #include "threads/palloc.h"
 #include "threads/thread.h"
 #include "threads/vaddr.h"
+#include "userprog/futex.h"
 #include "userprog/gdt.h"
 #include "userprog/tss.h"
 #ifdef VM
@@ -29,6 +30,7 @@ static void process_cleanup(void);
 static bool load(const char *file_name, struct intr_frame *if_);
 static void initd(void *f_name);
 static void __do_fork(void *);
+static void start_clone(void *);
 struct thread *get_child_with_pid(tid_t tid);
 
 /* initd와 다른 프로세스를 위한 일반 프로세스 초기화 함수 */
@@ -211,7 +213,7 @@ static void __do_fork(void *aux) {
     process_activate(current);
 #ifdef VM
     supplemental_page_table_init(&current->spt);
-    if (!supplemental_page_table_copy(&current->spt, &parent->spt)) {
+    if (!supplemental_page_table_copy(&current->spt, &parent->leader->spt)) {
         succ = false;
         goto error;
     }
@@ -249,7 +251,7 @@ static void __do_fork(void *aux) {
         current->fdt[fd] = new_file;
         
     }
-    current->fd_idx = parent->fd_idx;
+    current->fd_idx = parent->leader->fd_idx;
 
     /* 마지막으로, 새롭게 생성된 프로세스로 전환합니다. */
     /* Finally, switch to the newly created process. */
@@ -262,6 +264,151 @@ error:
     thread_exit();
 }
 
+/* clone()에 넘기는 인자. */
+/* Arguments passed to clone(). */
+struct clone_args {
+    struct thread *leader;      /* 새 스레드가 속할 프로세스의 주 스레드. *//* Main thread of the new thread's process. */
+    uintptr_t entry;            /* 사용자 진입점. *//* User entry point. */
+    uintptr_t arg;              /* ENTRY의 인자. *//* Argument to ENTRY. */
+    uintptr_t stack;            /* 사용자 스택의 꼭대기. *//* Top of the user stack. */
+};
+
+/* 현재 프로세스에 스레드를 하나 더 만듭니다. 새 스레드는 pml4, spt, fdt를 공유하며
+ * STACK을 스택으로 삼아 사용자 모드의 ENTRY(ARG)에서 시작합니다. ENTRY는 반환하지 말고
+ * exit_thread()나 exit()로 끝나야 합니다. 새 스레드의 tid, 실패하면 TID_ERROR를 반환합니다. */
+/* Adds a thread to the current process.  The new thread shares
+ * our pml4, spt and fdt, and starts in user mode at ENTRY(ARG)
+ * on the stack whose top is STACK.  ENTRY must not return; it
+ * ends with exit_thread() or exit().  Returns the new thread's
+ * tid, or TID_ERROR if it cannot be created. */
+tid_t process_clone(void *entry, void *arg, void *stack) {
+    struct thread *curr = thread_current();
+    struct clone_args args = {curr->leader, (uintptr_t)entry, (uintptr_t)arg, (uintptr_t)stack};
+    struct thread *child;
+    enum intr_level old_level;
+    tid_t tid;
+
+    if (curr->leader->exiting)
+        return TID_ERROR;
+    tid = thread_create(curr->name, PRI_DEFAULT, start_clone, &args);
+    if (tid == TID_ERROR)
+        return TID_ERROR;
+
+    /* 새 스레드가 ARGS를 다 읽을 때까지 기다립니다. 새 스레드는 자식 프로세스가
+     * 아니므로 child_list에서 빼고 프로세스의 members로 옮깁니다. */
+    /* Wait until the new thread is done with ARGS.  It is not a
+     * child process, so move it from our child_list to the
+     * process's members. */
+    child = get_child_with_pid(tid);
+    sema_down(&child->fork_sema);
+    list_remove(&child->child_elem);
+    old_level = intr_disable();
+    list_push_back(&curr->leader->members, &child->member_elem);
+    intr_set_level(old_level);
+    return tid;
+}
+
+/* process_clone()이 만든 스레드의 시작 함수. 주 스레드의 자원을 물려받아 사용자 모드로 갑니다. */
+/* Thread function of a thread made by process_clone().  Takes
+ * on the main thread's resources and drops to user mode. */
+static void start_clone(void *aux) {
+    struct clone_args *args = aux;
+    struct thread *current = thread_current();
+    struct thread *leader = args->leader;
+    struct intr_frame if_;
+
+    memset(&if_, 0, sizeof if_);
+    if_.ds = if_.es = if_.ss = SEL_UDSEG;
+    if_.cs = SEL_UCSEG;
+    if_.eflags = FLAG_IF | FLAG_MBS;
+    if_.rip = args->entry;
+    if_.R.rdi = args->arg;
+    /* 함수에 막 들어온 것처럼, 반환 주소 자리만큼 16바이트 경계에서 내려 둡니다. */
+    /* As if just called: 16-byte aligned, less a return
+     * address slot. */
+    if_.rsp = (args->stack & ~(uintptr_t)0xf) - sizeof(void *);
+
+    current->leader = leader;
+    thread_fdt_free(current);
+    current->fdt = leader->fdt;
+    current->pml4 = leader->pml4;
+    process_activate(current);
+
+    sema_up(&current->fork_sema);
+    do_iret(&if_);
+    NOT_REACHED();
+}
+
+/* 같은 프로세스의 스레드 TID가 끝나기를 기다려 exit_thread()에 넘긴 상태를 반환합니다.
+ * TID가 그런 스레드가 아니거나, 이미 join되었거나, 호출한 스레드 자신이면 바로 -1을 반환합니다.
+ * 주 스레드는 join할 수 없습니다. */
+/* Waits for thread TID of the same process to end and returns
+ * the status it passed to exit_thread().  Returns -1 at once if
+ * TID is no such thread, has already been joined, or is the
+ * caller.  The main thread cannot be joined. */
+int process_join(tid_t tid) {
+    struct thread *curr = thread_current();
+    struct list *members = &curr->leader->members;
+    struct thread *t = NULL;
+    enum intr_level old_level;
+    struct list_elem *e;
+    int status;
+
+    /* 찾은 스레드는 목록에서 빼 두어, 다른 스레드나 프로세스 종료가 다시 거두지 않게 합니다. */
+    /* Take the thread off the list, so that neither another
+     * joiner nor process exit reaps it again. */
+    old_level = intr_disable();
+    for (e = list_begin(members); e != list_end(members); e = list_next(e)) {
+        struct thread *m = list_entry(e, struct thread, member_elem);
+
+        if (m->tid == tid && m != curr) {
+            list_remove(e);
+            t = m;
+            break;
+        }
+    }
+    intr_set_level(old_level);
+    if (t == NULL)
+        return -1;
+
+    sema_down(&t->wait_sema);
+    status = t->exit_status;
+    thread_rusage_absorb(t);
+    sema_up(&t->free_sema);
+    return status;
+}
+
+/* 현재 프로세스의 모든 스레드가 끝나도록 표시하고, 처음 표시했다면 종료 상태를
+ * STATUS로 정하고 true를 반환합니다. 나머지 스레드는 다음에 커널에서 사용자 모드로
+ * 돌아가려 할 때 끝납니다. futex에 잠든 스레드는 여기서 깨웁니다. */
+/* Marks all threads of the current process for exit.  The first
+ * call sets the exit status to STATUS and returns true.  The
+ * other threads end the next time they would return from the
+ * kernel to user mode; those asleep on a futex are woken up
+ * here so that they do. */
+bool process_kill(int status) {
+    struct thread *leader = thread_current()->leader;
+    enum intr_level old_level;
+    bool first;
+
+    old_level = intr_disable();
+    first = !leader->exiting;
+    if (first) {
+        leader->exiting = true;
+        leader->exit_status = status;
+    }
+    intr_set_level(old_level);
+    if (first)
+        futex_release(leader->pml4);
+    return first;
+}
+
+/* 현재 프로세스가 끝나는 중이면 true를 반환합니다. */
+/* Returns true if the current process is exiting. */
+bool process_exiting(void) {
+    return thread_current()->leader->exiting;
+}
+
 /* 현재 실행 컨텍스트를 f_name으로 전환합니다.
  * 실패 시 -1을 반환합니다. */
 /* Switch the current execution context to the f_name.
@@ -393,6 +540,7 @@ int process_wait(tid_t child_tid UNUSED) {
 
     sema_down(&child -> wait_sema);   // sema down (wait sema)- wait 리스트에 부모 프로세스 추가 (자식 프로세스가 종료 될 때까지)
     int exit_status = child -> exit_status;   // 자식 프로세스의 종료를 알림 
+    thread_rusage_collect(child);     // 자식의 자원 사용량을 부모에게 합산
     list_remove(&child -> child_elem);  // wait list 에서 remove 
     sema_up(&child -> free_sema);     // sema_up (free_sema) 
 
@@ -416,13 +564,6 @@ void process_exit(void) {
      * TODO: We recommend you to implement process resource cleanup here. */
 
 
-    // 자식 프로세스의 종료를 대기 중인 부모 프로세스에게 알림 (세마포어 이용)   
-    // 유저 프로세스가 종료되면 부모 프로세스 대기 상태 이탈 후 진행  
-    // 프로세스 디스크립터에 프로세스 종료를 알림 (종료 플래그 설정)
-    for (int fd = 0; fd < FDT_COUNT_LIMIT; fd++){
-        close(fd);
-    }
-
     struct list_elem *child;
     for (child = list_begin(&thread_current()->child_list); // childs 순회
          child != list_end(&thread_current()->child_list); child = list_next(child))
@@ -430,8 +571,44 @@ void process_exit(void) {
         struct thread *t = list_entry(child, struct thread, child_elem);
         sema_up(&t->free_sema);
     }
+
+    // 추가 스레드는 공유하는 자원을 그대로 두고, 주소 공간에서 빠져나온 뒤에 끝났음을 알립니다.
+    // 그 뒤로는 주 스레드가 주소 공간을 없애도 됩니다.
+    if (curr->leader != curr) {
+        curr->fdt = NULL;
+        curr->pml4 = NULL;
+        pml4_activate(NULL);
+        sema_up(&curr->wait_sema);
+        sema_down(&curr->free_sema);
+        return;
+    }
+
+    // 주 스레드는 공유 자원을 정리하기 전에 남은 스레드를 모두 끝내고 거둡니다.
+    if (!list_empty(&curr->members)) {
+        process_kill(curr->exit_status);
+        for (;;) {
+            enum intr_level old_level = intr_disable();
+            struct thread *m = NULL;
+
+            if (!list_empty(&curr->members))
+                m = list_entry(list_pop_front(&curr->members), struct thread, member_elem);
+            intr_set_level(old_level);
+            if (m == NULL)
+                break;
+            sema_down(&m->wait_sema);
+            thread_rusage_absorb(m);
+            sema_up(&m->free_sema);
+        }
+    }
+
+    // 자식 프로세스의 종료를 대기 중인 부모 프로세스에게 알림 (세마포어 이용)   
+    // 유저 프로세스가 종료되면 부모 프로세스 대기 상태 이탈 후 진행  
+    // 프로세스 디스크립터에 프로세스 종료를 알림 (종료 플래그 설정)
+    for (int fd = 0; fd < FDT_COUNT_LIMIT; fd++){
+        close(fd);
+    }
     // 메모리 누수 방지
-    palloc_free_page(curr->fdt);
+    thread_fdt_free(curr);
     // 실행중에 수정 못하도록
     file_close(curr->running);
 
@@ -579,16 +756,16 @@ static bool load(const char *file_name, struct intr_frame *if_) {
     /* (프로그램 파일) 실행 파일을 엽니다. */
     /* Open executable file. */
     
-    lock_acquire(&filesys_lock);
+    rwlock_acquire_write(&filesys_lock);
     file = filesys_open(file_name);
     if (file == NULL) {
-        lock_release(&filesys_lock);
+        rwlock_release_write(&filesys_lock);
         printf("load: %s: open failed\n", file_name);
         goto done;
     }
     t -> running = file_reopen(file);
     file_deny_write(t->running);
-    lock_release(&filesys_lock);
+    rwlock_release_write(&filesys_lock);
 
     /* 실행 가능한 헤더를 읽고 확인합니다. */
     /* Read and verify executable header. */
@@ -11,6 +11,7 @@
 #include "threads/interrupt.h"
 #include "threads/loader.h"
 #include "threads/thread.h"
+#include "userprog/futex.h"
 #include "userprog/gdt.h"
 #include "userprog/process.h"
 #include <threads/palloc.h>
@@ -35,6 +36,16 @@ unsigned tell(int fd);
 void close (int fd);
 int wait (pid_t pid);
 int exec(const char *cmd_line);
+bool set_deadline(unsigned runtime, unsigned period);
+int cpu_group_create(unsigned quota, unsigned period);
+bool cpu_group_join(int group);
+bool cpu_group_usage(int group, long long *consumed, long long *throttled);
+int getrusage(int who, struct rusage *usage);
+int futex_wait(int *addr, int expected, int timeout);
+int futex_wake(int *addr, int n);
+tid_t clone(void (*fn)(void *), void *arg, void *stack);
+int join(tid_t tid);
+void exit_thread(int status);
 
 /* 시스템 호출.
  *
@@ -76,7 +87,8 @@ syscall_init (void) {
 	write_msr(MSR_SYSCALL_MASK,
 			FLAG_IF | FLAG_TF | FLAG_DF | FLAG_IOPL | FLAG_AC | FLAG_NT);
 
-    lock_init(&filesys_lock);
+    rwlock_init(&filesys_lock);
+    futex_init();
 }
 
 /* 주요 시스템 호출 인터페이스 */
@@ -128,10 +140,44 @@ void syscall_handler(struct intr_frame *f UNUSED) {
         case SYS_CLOSE:
             close(f->R.rdi);
             break;
+        case SYS_SET_DEADLINE:
+            f->R.rax = set_deadline(f->R.rdi, f->R.rsi);
+            break;
+        case SYS_CPU_GROUP_CREATE:
+            f->R.rax = cpu_group_create(f->R.rdi, f->R.rsi);
+            break;
+        case SYS_CPU_GROUP_JOIN:
+            f->R.rax = cpu_group_join(f->R.rdi);
+            break;
+        case SYS_CPU_GROUP_USAGE:
+            f->R.rax = cpu_group_usage(f->R.rdi, f->R.rsi, f->R.rdx);
+            break;
+        case SYS_GETRUSAGE:
+            f->R.rax = getrusage(f->R.rdi, f->R.rsi);
+            break;
+        case SYS_FUTEX_WAIT:
+            f->R.rax = futex_wait(f->R.rdi, f->R.rsi, f->R.rdx);
+            break;
+        case SYS_FUTEX_WAKE:
+            f->R.rax = futex_wake(f->R.rdi, f->R.rsi);
+            break;
+        case SYS_CLONE:
+            f->R.rax = clone(f->R.rdi, f->R.rsi, f->R.rdx);
+            break;
+        case SYS_JOIN:
+            f->R.rax = join(f->R.rdi);
+            break;
+        case SYS_EXIT_THREAD:
+            exit_thread(f->R.rdi);
+            break;
         default:
             thread_exit();
             break;
     }
+
+    /* 같은 프로세스의 다른 스레드가 exit()했다면 사용자 모드로 돌아가지 않습니다. */
+    if (process_exiting())
+        thread_exit();
 }
 
 /* 주소 유효성 검수하는 함수 */
@@ -166,7 +212,10 @@ void halt() {
 void exit(int status) {
     // 추후 종료 시 프로세스이름과 상태를 출력하는 메시지 추가
     struct thread *t = thread_current();
-    t->exit_status = status;
+
+    // 프로세스의 모든 스레드를 끝냅니다. 메시지는 처음 exit()한 스레드만 출력합니다.
+    if (!process_kill(status))
+        thread_exit();
     
     char *original_str = t->name; // 가정: t->name이 "dadsa-dasd o q"
     char *first_token,*save_ptr;
@@ -175,7 +224,7 @@ void exit(int status) {
 
     if (first_token != NULL) {
         // 토큰이 성공적으로 추출되었다면, 이를 다루는 로직
-          printf("%s: exit(%d)\n", first_token, t->exit_status);
+          printf("%s: exit(%d)\n", first_token, status);
     }
  
     thread_exit();
@@ -183,17 +232,31 @@ void exit(int status) {
 
 bool create(const char *name, unsigned initial_size) {
     check_address(name);
-    return filesys_create(name, initial_size);
+
+    rwlock_acquire_write(&filesys_lock);
+    bool success = filesys_create(name, initial_size);
+    rwlock_release_write(&filesys_lock);
+
+    return success;
 }
 
 bool remove(const char *name) {
     check_address(name);
-    return filesys_remove(name);
+
+    rwlock_acquire_write(&filesys_lock);
+    bool success = filesys_remove(name);
+    rwlock_release_write(&filesys_lock);
+
+    return success;
 }
 
 int open(const char *name) {
     check_address(name);
+
+    // 디렉터리 탐색만 하므로 읽기 락이면 충분합니다.
+    rwlock_acquire_read(&filesys_lock);
     struct file *file_obj = filesys_open(name);
+    rwlock_release_read(&filesys_lock);
     if (file_obj == NULL) {
         return -1;
     }
@@ -221,9 +284,9 @@ int write(int fd, const void *buffer, unsigned size) {
         result = size;
     }
     else { 
-        lock_acquire(&filesys_lock);
+        rwlock_acquire_write(&filesys_lock);
         result = file_write(file,buffer,size);
-        lock_release(&filesys_lock); 
+        rwlock_release_write(&filesys_lock);
     }
 
     return result;
@@ -233,19 +296,23 @@ int write(int fd, const void *buffer, unsigned size) {
 
 // 파일을 현재스레드의 fdt에 추가
 int add_file_to_fdt(struct file *file) {
-    struct thread *t = thread_current();
+    // fdt와 fd_idx는 주 스레드의 것을 프로세스의 모든 스레드가 함께 씁니다.
+    struct thread *t = thread_current()->leader;
     struct file **fdt = t->fdt;
+    enum intr_level old_level = intr_disable();
     int fd = t->fd_idx;
 
     while (t->fdt[fd] != NULL && fd < FDT_COUNT_LIMIT) {
         fd++;
     }
     if (fd >= FDT_COUNT_LIMIT) {
+        intr_set_level(old_level);
         return -1;
     }
 
     t->fd_idx = fd;
     fdt[fd] = file;
+    intr_set_level(old_level);
     
     // filesize(fd);
     return fd;
@@ -266,7 +333,9 @@ int filesize(int fd) {
       return - 1;
     }
     
-    int size = file_length(file); 
+    rwlock_acquire_read(&filesys_lock);
+    int size = file_length(file);
+    rwlock_release_read(&filesys_lock);
 
     return size; 
 }
@@ -291,12 +360,11 @@ int read(int fd, void *buffer, unsigned size) {
     // 구현 필요
     // lock을 이용해서 커널이 파일을 읽는 동안 다른 스레드가 이 파일을 읽는 것을 막아야함
 
-    // filesys_lock 선언(syscall.h에 만들기)
-    // syscall_init에도 lock 초기화함수 lock_init을 선언  
-    lock_acquire(&filesys_lock);
+    // 읽기만 하므로 읽기 락을 잡아 다른 읽기와 함께 진행합니다.
+    rwlock_acquire_read(&filesys_lock);
     // 그 외는 파일 객체 찾고, size 바이트 크기 만큼 파일을 읽어서 버퍼에 넣어준다.
     off_t read_count = file_read (file, buffer, size);
-    lock_release(&filesys_lock);
+    rwlock_release_read(&filesys_lock);
 
     return read_count;
 }
@@ -319,7 +387,12 @@ unsigned tell (int fd) {
     if (file == NULL) {
       return -1;
     }
-    return file_tell(file);
+
+    rwlock_acquire_read(&filesys_lock);
+    unsigned position = file_tell(file);
+    rwlock_release_read(&filesys_lock);
+
+    return position;
 }
 
 void close (int fd) {
@@ -329,10 +402,97 @@ void close (int fd) {
       return -1;
     }
 
+    rwlock_acquire_write(&filesys_lock);
     file_close(file);
+    rwlock_release_write(&filesys_lock);
     delete_file_from_fdt(fd);
 }
 
+/* 현재 스레드가 주기 PERIOD틱마다 RUNTIME틱을 보장받는 EDF 스레드가 되도록 요청합니다.
+   둘 다 0이면 EDF에서 빠집니다. 허용되지 않으면 false를 반환합니다. */
+bool set_deadline (unsigned runtime, unsigned period) {
+    return thread_set_deadline(runtime, period);
+}
+
+/* 현재 스레드가 속한 그룹 아래에 주기 PERIOD틱마다 QUOTA틱을 쓸 수 있는 그룹을 만듭니다. */
+int cpu_group_create (unsigned quota, unsigned period) {
+    return thread_group_create(thread_group_current(), quota, period);
+}
+
+/* 현재 프로세스의 모든 스레드를 GROUP으로 옮깁니다. GROUP은 지금 그룹이거나 그 아래여야 합니다.
+   이후 fork한 자식도 같은 그룹에 속합니다. */
+bool cpu_group_join (int group) {
+    return thread_group_join(group);
+}
+
+/* GROUP이 쓴 틱 수와 멈춰 있던 틱 수를 사용자 메모리에 씁니다. */
+bool cpu_group_usage (int group, long long *consumed, long long *throttled) {
+    long long c, t;
+
+    check_address(consumed);
+    check_address((char *) consumed + sizeof *consumed - 1);
+    check_address(throttled);
+    check_address((char *) throttled + sizeof *throttled - 1);
+    if (!thread_group_usage(group, &c, &t))
+        return false;
+    *consumed = c;
+    *throttled = t;
+    return true;
+}
+
+/* 현재 프로세스(RUSAGE_SELF) 또는 기다려 준 자식들(RUSAGE_CHILDREN)의 자원 사용량을 USAGE에 씁니다.
+   프로세스의 사용량에는 모든 스레드의 사용량이 들어갑니다. */
+int getrusage (int who, struct rusage *usage) {
+    struct rusage copy;
+
+    check_address(usage);
+    check_address((char *) usage + sizeof *usage - 1);
+    if (who != RUSAGE_SELF && who != RUSAGE_CHILDREN)
+        return -1;
+
+    thread_rusage_process(who == RUSAGE_CHILDREN, &copy);
+    *usage = copy;
+    return 0;
+}
+
+/* *ADDR가 EXPECTED인 동안 futex_wake()나 TIMEOUT 틱(0이면 무한)까지 잠듭니다. */
+int futex_wait (int *addr, int expected, int timeout) {
+    check_address(addr);
+    if ((uintptr_t) addr % sizeof *addr != 0 || timeout < 0)
+        return -1;
+    return futex_sleep(addr, expected, timeout);
+}
+
+/* ADDR에 잠든 스레드를 최대 N개 깨우고 깨운 수를 반환합니다. */
+int futex_wake (int *addr, int n) {
+    check_address(addr);
+    if ((uintptr_t) addr % sizeof *addr != 0 || n < 0)
+        return -1;
+    return futex_wakeup(addr, n);
+}
+
+/* 현재 프로세스에 STACK을 스택으로 쓰며 FN(ARG)에서 시작하는 스레드를 더합니다. */
+tid_t clone (void (*fn) (void *), void *arg, void *stack) {
+    if (!is_user_vaddr(fn) || !is_user_vaddr((char *) stack - 1))
+        return TID_ERROR;
+    return process_clone(fn, arg, stack);
+}
+
+/* 같은 프로세스의 스레드 TID가 끝나기를 기다려 그 상태를 반환합니다. */
+int join (tid_t tid) {
+    return process_join(tid);
+}
+
+/* 현재 스레드만 끝냅니다. 주 스레드라면 exit()처럼 프로세스 전체를 끝냅니다. */
+void exit_thread (int status) {
+    struct thread *t = thread_current();
+
+    if (t->leader == t)
+        exit(status);
+    t->exit_status = status;
+    thread_exit();
+}
+
 pid_t fork (const char *thread_name) {
     check_address(thread_name);
     struct intr_frame *if_ = pg_round_up(&thread_name) - sizeof(struct intr_frame);
@@ -353,6 +513,11 @@ int exec (const char *cmd_line) {
     check_address(cmd_line);
     char *fn_copy;
 
+    // 다른 스레드가 쓰고 있는 주소 공간을 바꿀 수는 없습니다.
+    struct thread *t = thread_current();
+    if (t->leader != t || !list_empty(&t->members))
+        return -1;
+
     off_t size = strlen(cmd_line) + 1;
     fn_copy = palloc_get_page(PAL_ZERO);
     if (fn_copy == NULL)